@@ -0,0 +1,109 @@
+/*
+ * File: arena.c
+ * Description: Bump allocator for per-game and per-simulation scratch.
+ *
+ *   The solver's candidate sets, the strategy builder's saved sets at
+ *   each branch, and the games --simulate-all plays are carved from an
+ *   Arena instead of malloc, as is the solver --solve plays with.
+ *   Allocation is a pointer bump; a game boundary is one arena_release
+ *   back to a mark, and the blocks are kept so steady-state games never
+ *   reach the heap. Each thread has its own arena (arena_thread) or
+ *   owns one outright, so there is no locking.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "arena.h"
+
+struct ArenaBlock {
+    ArenaBlock *next;
+    size_t size;
+    _Alignas(ARENA_ALIGN) unsigned char data[];
+};
+
+void arena_init(Arena *arena, size_t block_size) {
+    memset(arena, 0, sizeof(*arena));
+    arena->block_size = block_size > 0 ? block_size : ARENA_BLOCK_SIZE;
+}
+
+static ArenaBlock *new_block(size_t size) {
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + size);
+    if (block == NULL) {
+        perror("Failed to allocate arena");
+        exit(EXIT_FAILURE);
+    }
+    block->next = NULL;
+    block->size = size;
+    return block;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    if (arena->current == NULL || arena->offset + size > arena->current->size) {
+        // Reuse the next kept block when it is big enough, otherwise
+        // splice a fresh one in after the current block
+        ArenaBlock *next = arena->current != NULL ? arena->current->next : arena->first;
+        if (next == NULL || next->size < size) {
+            ArenaBlock *block = new_block(size > arena->block_size ? size : arena->block_size);
+            block->next = next;
+            if (arena->current != NULL) {
+                arena->current->next = block;
+            } else {
+                arena->first = block;
+            }
+            next = block;
+        }
+        arena->current = next;
+        arena->offset = 0;
+    }
+
+    void *memory = arena->current->data + arena->offset;
+    arena->offset += size;
+    arena->in_use += size;
+    if (arena->in_use > arena->peak) {
+        arena->peak = arena->in_use;
+    }
+    return memory;
+}
+
+ArenaMark arena_mark(const Arena *arena) {
+    ArenaMark mark = {arena->current, arena->offset, arena->in_use};
+    return mark;
+}
+
+void arena_release(Arena *arena, ArenaMark mark) {
+    arena->current = mark.block;
+    arena->offset = mark.offset;
+    arena->in_use = mark.in_use;
+}
+
+// Returns the high-water mark and restarts it from the current usage
+size_t arena_reset_peak(Arena *arena) {
+    size_t peak = arena->peak;
+    arena->peak = arena->in_use;
+    return peak;
+}
+
+void arena_free(Arena *arena) {
+    ArenaBlock *block = arena->first;
+    while (block != NULL) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena_init(arena, arena->block_size);
+}
+
+Arena *arena_thread(void) {
+    static _Thread_local Arena arena;
+    static _Thread_local bool initialised;
+
+    if (!initialised) {
+        arena_init(&arena, ARENA_BLOCK_SIZE);
+        initialised = true;
+    }
+    return &arena;
+}
@@ -0,0 +1,43 @@
+// arena.h
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARENA_BLOCK_SIZE (64u << 10)
+#define ARENA_ALIGN 16
+
+typedef struct ArenaBlock ArenaBlock;
+
+// Bump allocator over a chain of blocks. Nothing is freed individually:
+// memory comes back all at once through arena_release to a mark, and the
+// blocks stay attached for reuse. in_use and peak count the bytes
+// handed out, so a caller can find out how much one game really needs.
+typedef struct {
+    ArenaBlock *first;
+    ArenaBlock *current;
+    size_t offset;          // bytes used in current
+    size_t block_size;
+    size_t in_use;
+    size_t peak;            // largest in_use since arena_reset_peak
+} Arena;
+
+// A position to rewind to; everything allocated after it is released
+typedef struct {
+    ArenaBlock *block;
+    size_t offset;
+    size_t in_use;
+} ArenaMark;
+
+// Function declarations
+void arena_init(Arena *arena, size_t block_size);
+void *arena_alloc(Arena *arena, size_t size);
+ArenaMark arena_mark(const Arena *arena);
+void arena_release(Arena *arena, ArenaMark mark);
+size_t arena_reset_peak(Arena *arena);
+void arena_free(Arena *arena);
+Arena *arena_thread(void);
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * File: constraints.c
+ * Description: Incremental hint state for hard mode and the solver.
+ *
+ *   Rather than re-scoring a word against every earlier guess, the
+ *   feedback is folded into one Constraints value as it arrives: greens
+ *   become a mask/value pair over the packed word, every non-green result
+ *   rules its letter out of that position, and each guess tightens the
+ *   per-letter count bounds. Checking a word is then a compare, a few
+ *   shifts and a five-letter count.
+ */
+
+#include <string.h>
+#include "constraints.h"
+
+void constraints_init(Constraints *c) {
+    memset(c, 0, sizeof(*c));
+    memset(c->max_count, WORD_LENGTH, 26);
+}
+
+void constraints_update(Constraints *c, uint32_t guess, uint8_t pattern) {
+    uint8_t letters[WORD_LENGTH];
+    uint8_t scores[WORD_LENGTH];
+    uint8_t marked[LETTER_MASK + 1] = {0};
+    uint32_t absent = 0;
+
+    for (int i = 0; i < WORD_LENGTH; i++, pattern /= 3) {
+        letters[i] = (guess >> (LETTER_BITS * i)) & LETTER_MASK;
+        scores[i] = pattern % 3;
+    }
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        uint32_t letter = letters[i];
+        if (letter > 25) {
+            continue;
+        }
+        if (scores[i] == CORRECT_LETTER_CORRECT_POSITION) {
+            uint32_t shift = LETTER_BITS * (uint32_t)i;
+            c->fixed_mask |= (uint32_t)LETTER_MASK << shift;
+            c->fixed_value |= letter << shift;
+        } else {
+            c->excluded[i] |= UINT32_C(1) << letter;
+        }
+        if (scores[i] == 0) {
+            absent |= UINT32_C(1) << letter;
+        } else {
+            marked[letter]++;
+        }
+    }
+
+    // A grey next to n marked copies caps the letter at exactly n
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        uint32_t letter = letters[i];
+        if (letter > 25) {
+            continue;
+        }
+        if (marked[letter] > c->min_count[letter]) {
+            c->min_count[letter] = marked[letter];
+            c->required |= UINT32_C(1) << letter;
+        }
+        if ((absent >> letter) & 1) {
+            c->max_count[letter] = marked[letter];
+        }
+    }
+}
@@ -0,0 +1,76 @@
+// constraints.h
+
+#ifndef CONSTRAINTS_H
+#define CONSTRAINTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "score.h"
+
+// Everything the feedback so far says about the secret. Count tables are
+// indexed by packed letter and cover LETTER_INVALID, whose bounds are 0.
+typedef struct {
+    uint32_t fixed_mask;              // packed-word bits of the known greens
+    uint32_t fixed_value;
+    uint32_t excluded[WORD_LENGTH];   // 26-bit masks of letters ruled out per position
+    uint32_t required;                // letters with min_count > 0
+    uint8_t min_count[LETTER_MASK + 1];
+    uint8_t max_count[LETTER_MASK + 1];
+} Constraints;
+
+// Function declarations
+void constraints_init(Constraints *c);
+void constraints_update(Constraints *c, uint32_t guess, uint8_t pattern);
+
+// Occurrences of letter i of `packed` anywhere in the word
+static inline void constraints_count_letters(uint32_t packed, uint8_t *letters, uint8_t *counts) {
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        letters[i] = (packed >> (LETTER_BITS * i)) & LETTER_MASK;
+    }
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        counts[i] = 0;
+        for (int j = 0; j < WORD_LENGTH; j++) {
+            counts[i] += letters[i] == letters[j];
+        }
+    }
+}
+
+// Hard-mode rule: greens stay in place and every revealed letter is reused
+static inline bool constraints_allows_guess(const Constraints *c, uint32_t packed) {
+    if ((packed & c->fixed_mask) != c->fixed_value) {
+        return false;
+    }
+    if (c->required == 0) {
+        return true;
+    }
+
+    uint8_t letters[WORD_LENGTH], counts[WORD_LENGTH];
+    uint32_t present = 0;
+    constraints_count_letters(packed, letters, counts);
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        present |= (uint32_t)(counts[i] >= c->min_count[letters[i]]) << letters[i];
+    }
+    return (present & c->required) == c->required;
+}
+
+// Whether `packed` could still be the secret
+static inline bool constraints_admits(const Constraints *c, uint32_t packed) {
+    if ((packed & c->fixed_mask) != c->fixed_value) {
+        return false;
+    }
+
+    uint8_t letters[WORD_LENGTH], counts[WORD_LENGTH];
+    uint32_t present = 0;
+    constraints_count_letters(packed, letters, counts);
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        uint32_t letter = letters[i];
+        if (((c->excluded[i] >> letter) & 1) || counts[i] > c->max_count[letter]) {
+            return false;
+        }
+        present |= (uint32_t)(counts[i] >= c->min_count[letter]) << letter;
+    }
+    return (present & c->required) == c->required;
+}
+
+#endif
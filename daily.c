@@ -0,0 +1,149 @@
+/*
+ * File: daily.c
+ * Description: Word-of-the-day secrets from a precomputed schedule.
+ *
+ *   wordle-pack --with-schedule stores a seeded permutation of the word
+ *   indices in the dictionary (see dict.h). The puzzle for a date is entry
+ *   (day - epoch) mod count of that table, so every process, and every
+ *   session in one process, agrees on the word without drawing anything,
+ *   and the calendar only repeats after the whole list has been used.
+ *
+ *   daily_secret resolves a day once: the first caller builds a
+ *   DailySecret (the word and its PreparedSecret tables) under a lock, and
+ *   everyone after that gets the same pointer from one atomic load.
+ *   Superseded days stay allocated until daily_close, since games that
+ *   started on them may still be running.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "wordle.h"
+#include "score.h"
+#include "daily.h"
+
+// Days from 1970-01-01 in the proleptic Gregorian calendar (Howard
+// Hinnant's days_from_civil)
+static int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned year_of_era = (unsigned)(year - era * 400);
+    unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + (int64_t)day_of_era - 719468;
+}
+
+static unsigned days_in_month(int64_t year, unsigned month) {
+    static const unsigned lengths[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : lengths[month - 1];
+}
+
+// Parses YYYY-MM-DD, rejecting days the month does not have
+bool daily_parse_date(const char *text, int64_t *day) {
+    int year;
+    unsigned month, mday;
+    char extra;
+
+    if (sscanf(text, "%d-%u-%u%c", &year, &month, &mday, &extra) != 3 ||
+        month < 1 || month > 12 || mday < 1 || mday > days_in_month(year, month)) {
+        return false;
+    }
+    *day = days_from_civil(year, month, mday);
+    return true;
+}
+
+// Today in local time, which is when players expect the puzzle to change
+int64_t daily_today(void) {
+    time_t now = time(NULL);
+    struct tm local;
+
+    localtime_r(&now, &local);
+    return days_from_civil(local.tm_year + 1900, (unsigned)local.tm_mon + 1, (unsigned)local.tm_mday);
+}
+
+// Header check only, for callers that treat a missing schedule as normal
+bool daily_has_schedule(const char *words_file) {
+    DictHeader header;
+    int fd = open(words_file, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool found = read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+                 dict_is_binary(&header, sizeof(header)) && (header.flags & DICT_HAS_SCHEDULE);
+    close(fd);
+    return found;
+}
+
+bool daily_open(const char *words_file, DailySchedule *schedule) {
+    memset(schedule, 0, sizeof(*schedule));
+
+    if (!daily_has_schedule(words_file)) {
+        fprintf(stderr, "%s has no daily schedule; pack it with wordle-pack --with-schedule.\n", words_file);
+        return false;
+    }
+    if (!dict_map(words_file, &schedule->view)) {
+        return false;
+    }
+
+    pthread_mutex_init(&schedule->lock, NULL);
+    atomic_init(&schedule->current, NULL);
+    return true;
+}
+
+static DailySecret *resolve(const DailySchedule *schedule, int64_t day) {
+    const DictSchedule *table = schedule->view.schedule;
+    DailySecret *secret = calloc(1, sizeof(*secret));
+    if (secret == NULL) {
+        return NULL;
+    }
+
+    int64_t number = day - table->epoch_day;
+    secret->day = day;
+    secret->number = (uint32_t)number;
+    secret->secret = schedule->view.schedule_order[number % table->length];
+    secret->secret_packed = dict_word(&schedule->view, secret->secret);
+    prepare_secret(secret->secret_packed, &secret->prepared);
+    return secret;
+}
+
+// The shared secret for `day`, or NULL before the schedule starts
+const DailySecret *daily_secret(DailySchedule *schedule, int64_t day) {
+    DailySecret *current = atomic_load_explicit(&schedule->current, memory_order_acquire);
+    if (current != NULL && current->day == day) {
+        return current;
+    }
+    if (day < schedule->view.schedule->epoch_day) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&schedule->lock);
+    current = atomic_load_explicit(&schedule->current, memory_order_relaxed);
+    if (current == NULL || current->day != day) {
+        DailySecret *secret = resolve(schedule, day);
+        if (secret != NULL) {
+            secret->retired = current;
+            atomic_store_explicit(&schedule->current, secret, memory_order_release);
+        }
+        current = secret;
+    }
+    pthread_mutex_unlock(&schedule->lock);
+
+    return current;
+}
+
+void daily_close(DailySchedule *schedule) {
+    DailySecret *secret = atomic_load_explicit(&schedule->current, memory_order_relaxed);
+    while (secret != NULL) {
+        DailySecret *retired = secret->retired;
+        free(secret);
+        secret = retired;
+    }
+
+    pthread_mutex_destroy(&schedule->lock);
+    dict_unmap(&schedule->view);
+}
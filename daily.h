@@ -0,0 +1,43 @@
+// daily.h
+
+#ifndef DAILY_H
+#define DAILY_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "dict.h"
+#include "score.h"
+
+// Puzzle #0 of the default schedule: the first public Wordle
+#define DAILY_DEFAULT_START "2021-06-19"
+#define DAILY_DEFAULT_SEED 0x5744494C59ull
+
+// One day's secret, resolved once and shared read-only by every game in
+// the process, with its scoring tables built up front
+typedef struct DailySecret {
+    int64_t day;                // days since 1970-01-01
+    uint32_t number;            // puzzle number, day - epoch
+    uint32_t secret;            // index into the dictionary
+    uint32_t secret_packed;
+    PreparedSecret prepared;
+    struct DailySecret *retired;    // earlier days, freed by daily_close
+} DailySecret;
+
+typedef struct {
+    DictView view;
+    pthread_mutex_t lock;
+    _Atomic(DailySecret *) current;
+} DailySchedule;
+
+// Function declarations
+bool daily_parse_date(const char *text, int64_t *day);
+int64_t daily_today(void);
+bool daily_has_schedule(const char *words_file);
+bool daily_open(const char *words_file, DailySchedule *schedule);
+const DailySecret *daily_secret(DailySchedule *schedule, int64_t day);
+void daily_close(DailySchedule *schedule);
+
+#endif
@@ -0,0 +1,369 @@
+/*
+ * File: dict.c
+ * Description: Compact binary dictionary format.
+ *
+ *   A dictionary file is a fixed header followed by the words as a bit
+ *   stream of packed records (five bits per letter, 25 bits for the classic
+ *   game) and, optionally, the daily-puzzle schedule, per-position and
+ *   per-word letter-frequency tables and the validation bitmap from
+ *   word_index.c. Only 5-letter
+ *   dictionaries carry the optional sections; 4-, 6- and 7-letter ones
+ *   hold just the words for the variant game (see variant.c). Files are
+ *   produced offline by wordle-pack and mmapped at startup with no parsing
+ *   beyond a header and checksum check.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "dict.h"
+#include "word_index.h"
+#include "variant.h"
+#include "rng.h"
+
+static uint32_t checksum_bytes(const uint8_t *data, size_t size) {
+    // 32-bit FNV-1a
+    uint32_t hash = 0x811c9dc5u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x01000193u;
+    }
+    return hash;
+}
+
+static size_t words_section_size(size_t count, unsigned int length) {
+    // Rounded up to whole bytes plus eight bytes of slack for dict_word
+    return (count * LETTER_BITS * length + 7) / 8 + 8;
+}
+
+bool dict_is_binary(const void *data, size_t size) {
+    return size >= sizeof(DictHeader) && memcmp(data, DICT_MAGIC, 4) == 0;
+}
+
+bool dict_view(const void *data, size_t size, DictView *view) {
+    if (!dict_is_binary(data, size)) {
+        return false;
+    }
+
+    const DictHeader *header = data;
+    if (header->version == DICT_VERSION_SWAPPED) {
+        fprintf(stderr, "Dictionary was packed on a machine of the other byte order; "
+                        "rebuild it with wordle-pack.\n");
+        return false;
+    }
+    if (header->version != DICT_VERSION || word_variant(header->word_length) == NULL) {
+        fprintf(stderr, "Unsupported dictionary format (version %u, %u-letter words).\n",
+                header->version, header->word_length);
+        return false;
+    }
+
+    if (header->words_offset < sizeof(DictHeader) ||
+        header->words_size < words_section_size(header->word_count, header->word_length) ||
+        (header->word_length != WORD_LENGTH &&
+         (header->flags & (DICT_HAS_LETTER_FREQ | DICT_HAS_WORD_INDEX | DICT_HAS_SCHEDULE))) ||
+        (size_t)header->words_offset + header->words_size > size ||
+        ((header->flags & DICT_HAS_LETTER_FREQ) &&
+         (size_t)header->freq_offset + sizeof(DictLetterFreq) > size) ||
+        ((header->flags & DICT_HAS_WORD_INDEX) &&
+         (header->index_offset % 8 != 0 || (size_t)header->index_offset + WORD_INDEX_BYTES > size)) ||
+        ((header->flags & DICT_HAS_SCHEDULE) &&
+         dict_schedule_offset(header) + sizeof(DictSchedule) + header->word_count * sizeof(uint32_t) > size)) {
+        fprintf(stderr, "Corrupt dictionary: sections out of bounds.\n");
+        return false;
+    }
+
+    const uint8_t *base = data;
+    if (checksum_bytes(base + header->words_offset, header->words_size) != header->checksum) {
+        fprintf(stderr, "Corrupt dictionary: checksum mismatch.\n");
+        return false;
+    }
+
+    memset(view, 0, sizeof(*view));
+    view->header = header;
+    view->words = base + header->words_offset;
+    view->count = header->word_count;
+    view->word_length = header->word_length;
+    if (header->flags & DICT_HAS_LETTER_FREQ) {
+        view->freq = (const DictLetterFreq *)(base + header->freq_offset);
+    }
+    if (header->flags & DICT_HAS_WORD_INDEX) {
+        view->index = (const uint64_t *)(base + header->index_offset);
+    }
+    if (header->flags & DICT_HAS_SCHEDULE) {
+        const DictSchedule *schedule = (const DictSchedule *)(base + dict_schedule_offset(header));
+        const uint32_t *order = (const uint32_t *)(schedule + 1);
+        bool valid = schedule->length == header->word_count;
+        for (size_t i = 0; valid && i < schedule->length; i++) {
+            valid = order[i] < header->word_count;
+        }
+        if (!valid) {
+            fprintf(stderr, "Corrupt dictionary: bad daily schedule.\n");
+            return false;
+        }
+        view->schedule = schedule;
+        view->schedule_order = order;
+    }
+    return true;
+}
+
+bool dict_map(const char *path, DictView *view) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open dictionary");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(DictHeader)) {
+        fprintf(stderr, "Failed to read dictionary header.\n");
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("Failed to map dictionary");
+        return false;
+    }
+
+    if (!dict_view(map, size, view)) {
+        munmap(map, size);
+        return false;
+    }
+
+    view->map = map;
+    view->map_size = size;
+    return true;
+}
+
+void dict_unmap(DictView *view) {
+    if (view->map != NULL) {
+        munmap(view->map, view->map_size);
+    }
+    memset(view, 0, sizeof(*view));
+}
+
+static void count_letters(const uint32_t *packed, size_t count, DictLetterFreq *freq) {
+    memset(freq, 0, sizeof(*freq));
+
+    for (size_t w = 0; w < count; w++) {
+        uint32_t seen = 0;
+        for (int i = 0; i < WORD_LENGTH; i++) {
+            unsigned int letter = (packed[w] >> (LETTER_BITS * i)) & LETTER_MASK;
+            freq->by_position[i][letter]++;
+            seen |= 1u << letter;
+        }
+        for (int letter = 0; letter < 26; letter++) {
+            freq->by_word[letter] += (seen >> letter) & 1;
+        }
+    }
+}
+
+// Pads the file with zeroes up to `offset`
+static bool pad_to(FILE *file, size_t *position, size_t offset) {
+    static const uint8_t zeroes[8];
+    size_t pad = offset - *position;
+    *position = offset;
+    return fwrite(zeroes, 1, pad, file) == pad;
+}
+
+static void put_record(uint8_t *words, size_t index, unsigned int bits, uint64_t value) {
+    size_t bit = index * bits;
+    // A 7-letter record at bit offset 7 spans 42 bits, still one uint64_t
+    value <<= bit % 8;
+    for (size_t i = 0; value != 0; i++, value >>= 8) {
+        words[bit / 8 + i] |= (uint8_t)value;
+    }
+}
+
+static void init_header(DictHeader *header, unsigned int length, size_t count,
+                        const uint8_t *words, size_t words_size) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, DICT_MAGIC, 4);
+    header->version = DICT_VERSION;
+    header->word_length = (uint8_t)length;
+    header->word_count = (uint32_t)count;
+    header->words_offset = sizeof(*header);
+    header->words_size = (uint32_t)words_size;
+    header->checksum = checksum_bytes(words, words_size);
+}
+
+// Writes the header, the words and whichever optional sections the header
+// flags, at the offsets it records
+static bool write_file(const char *path, const DictHeader *header, const uint8_t *words,
+                       const DictSchedule *schedule, const uint32_t *order,
+                       const DictLetterFreq *freq, const uint64_t *index) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("Failed to create dictionary");
+        return false;
+    }
+
+    size_t position = sizeof(*header) + header->words_size;
+    bool ok = fwrite(header, sizeof(*header), 1, file) == 1 &&
+              fwrite(words, 1, header->words_size, file) == header->words_size;
+    if (ok && (header->flags & DICT_HAS_SCHEDULE)) {
+        ok = pad_to(file, &position, dict_schedule_offset(header)) &&
+             fwrite(schedule, sizeof(*schedule), 1, file) == 1 &&
+             fwrite(order, sizeof(*order), schedule->length, file) == schedule->length;
+        position += sizeof(*schedule) + schedule->length * sizeof(*order);
+    }
+    if (ok && (header->flags & DICT_HAS_LETTER_FREQ)) {
+        ok = pad_to(file, &position, header->freq_offset) &&
+             fwrite(freq, sizeof(*freq), 1, file) == 1;
+        position += sizeof(*freq);
+    }
+    if (ok && (header->flags & DICT_HAS_WORD_INDEX)) {
+        ok = pad_to(file, &position, header->index_offset) &&
+             fwrite(index, 1, WORD_INDEX_BYTES, file) == WORD_INDEX_BYTES;
+        position += WORD_INDEX_BYTES;
+    }
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok) {
+        perror("Failed to write dictionary");
+        remove(path);
+    }
+    return ok;
+}
+
+// Fisher-Yates over the word indices, from a fixed seed so the same list
+// and options always produce the same calendar
+static uint32_t *shuffle_schedule(size_t count, uint64_t seed) {
+    uint32_t *order = malloc(count * sizeof(*order));
+    if (order == NULL) {
+        perror("Failed to allocate schedule");
+        return NULL;
+    }
+
+    Rng rng;
+    rng_seed(&rng, seed);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = (uint32_t)i;
+    }
+    for (size_t i = count; i > 1; i--) {
+        size_t j = (size_t)rng_bounded(&rng, i);
+        uint32_t t = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = t;
+    }
+    return order;
+}
+
+// `schedule` supplies the epoch and seed when flags has DICT_HAS_SCHEDULE
+bool dict_write(const char *path, const uint32_t *packed, size_t count, unsigned int flags,
+                const DictSchedule *schedule) {
+    size_t words_size = words_section_size(count, WORD_LENGTH);
+    uint8_t *words = calloc(1, words_size);
+    uint64_t *index = NULL;
+    uint32_t *order = NULL;
+    if (words == NULL) {
+        perror("Failed to allocate dictionary");
+        return false;
+    }
+
+    for (size_t w = 0; w < count; w++) {
+        put_record(words, w, DICT_WORD_BITS, packed[w]);
+    }
+
+    DictHeader header;
+    init_header(&header, WORD_LENGTH, count, words, words_size);
+
+    // Sections follow the words in a fixed order, each aligned for
+    // direct use from the mapping
+    size_t end = sizeof(header) + words_size;
+    DictSchedule table;
+    if (flags & DICT_HAS_SCHEDULE) {
+        order = shuffle_schedule(count, schedule->seed);
+        if (order == NULL) {
+            free(words);
+            return false;
+        }
+        table = *schedule;
+        table.length = (uint32_t)count;
+        header.flags |= DICT_HAS_SCHEDULE;
+        end = dict_schedule_offset(&header) + sizeof(table) + count * sizeof(*order);
+    }
+    DictLetterFreq freq;
+    if (flags & DICT_HAS_LETTER_FREQ) {
+        count_letters(packed, count, &freq);
+        header.flags |= DICT_HAS_LETTER_FREQ;
+        header.freq_offset = (uint32_t)((end + 3) & ~(size_t)3);
+        end = header.freq_offset + sizeof(freq);
+    }
+    if (flags & DICT_HAS_WORD_INDEX) {
+        index = malloc(WORD_INDEX_BYTES);
+        if (index == NULL) {
+            perror("Failed to allocate word index");
+            free(words);
+            free(order);
+            return false;
+        }
+        word_index_fill(packed, count, index);
+        header.flags |= DICT_HAS_WORD_INDEX;
+        header.index_offset = (uint32_t)((end + 7) & ~(size_t)7);
+        end = header.index_offset + WORD_INDEX_BYTES;
+    }
+
+    bool ok = write_file(path, &header, words, &table, order, &freq, index);
+    free(words);
+    free(index);
+    free(order);
+    return ok;
+}
+
+bool dict_write_variant(const char *path, const uint64_t *packed, size_t count, int length) {
+    size_t words_size = words_section_size(count, (unsigned int)length);
+    uint8_t *words = calloc(1, words_size);
+    if (words == NULL) {
+        perror("Failed to allocate dictionary");
+        return false;
+    }
+
+    for (size_t w = 0; w < count; w++) {
+        put_record(words, w, LETTER_BITS * (unsigned int)length, packed[w]);
+    }
+
+    DictHeader header;
+    init_header(&header, (unsigned int)length, count, words, words_size);
+
+    bool ok = write_file(path, &header, words, NULL, NULL, NULL, NULL);
+    free(words);
+    return ok;
+}
+
+// Reads word `index` with one pread, for callers that want a single
+// record without mapping and checksumming the whole file
+// False for anything dict_view would not accept as-is, so the caller falls
+// back to the full load and its error message
+bool dict_read_word(int fd, const DictHeader *header, size_t index, uint32_t *packed) {
+    if (header->version != DICT_VERSION || header->word_length != WORD_LENGTH || index >= header->word_count ||
+        (uint64_t)header->word_count * DICT_WORD_BITS > (uint64_t)header->words_size * 8) {
+        return false;
+    }
+
+    size_t bit = index * DICT_WORD_BITS;
+    uint8_t bytes[8] = {0};
+    size_t needed = (bit % 8 + DICT_WORD_BITS + 7) / 8;
+    if (pread(fd, bytes, sizeof(bytes), (off_t)header->words_offset + (off_t)(bit / 8)) < (ssize_t)needed) {
+        return false;
+    }
+
+    uint64_t chunk = 0;
+    for (int b = 0; b < 8; b++) {
+        chunk |= (uint64_t)bytes[b] << (8 * b);
+    }
+    uint32_t word = (uint32_t)(chunk >> (bit % 8)) & ((1u << DICT_WORD_BITS) - 1);
+    if (word_rank(word) == WORD_RANK_INVALID) {
+        return false;
+    }
+
+    *packed = word;
+    return true;
+}
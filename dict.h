@@ -0,0 +1,109 @@
+// dict.h
+
+#ifndef DICT_H
+#define DICT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "score.h"
+
+#define DICT_MAGIC "WDIC"
+#define DICT_VERSION 1
+// The version field as a machine of the other byte order reads it
+#define DICT_VERSION_SWAPPED ((uint16_t)(DICT_VERSION << 8))
+
+// Header flags
+#define DICT_HAS_LETTER_FREQ 0x01
+#define DICT_HAS_WORD_INDEX 0x02
+#define DICT_HAS_SCHEDULE 0x04
+
+// Bits per packed word: five bits per letter, no padding between words
+#define DICT_WORD_BITS (LETTER_BITS * WORD_LENGTH)
+
+// Fixed 32-byte header at offset 0; offsets are in bytes from the start of
+// the file. The word bit stream is little-endian byte by byte, but the
+// header and the other sections are written as the packing machine holds
+// them, so a file only reads back on a machine of the same byte order.
+// Readers of the other order see DICT_VERSION_SWAPPED and refuse the file.
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint8_t word_length;
+    uint8_t flags;
+    uint32_t word_count;
+    uint32_t checksum;      // FNV-1a over the packed word section
+    uint32_t words_offset;
+    uint32_t words_size;
+    uint32_t freq_offset;   // 0 unless DICT_HAS_LETTER_FREQ
+    uint32_t index_offset;  // 0 unless DICT_HAS_WORD_INDEX; 8-byte aligned
+} DictHeader;
+
+// Optional letter-frequency section
+typedef struct {
+    uint32_t by_position[WORD_LENGTH][26];  // words with letter L at position i
+    uint32_t by_word[26];                   // words containing letter L at all
+} DictLetterFreq;
+
+// Optional daily-puzzle schedule: this header, then `length` word indices
+// forming a permutation of the list. The header has no offset field to
+// spare, so the section always sits right after the words, 8-byte aligned
+// (see dict_schedule_offset), ahead of the other optional sections.
+typedef struct {
+    int32_t epoch_day;      // days since 1970-01-01 of puzzle #0
+    uint32_t length;        // word_count
+    uint64_t seed;          // shuffle seed, kept for reproducing the table
+} DictSchedule;
+
+// A mapped dictionary file; every field points into the mapping
+typedef struct {
+    const DictHeader *header;
+    const uint8_t *words;
+    const DictLetterFreq *freq;   // NULL when the file has no tables
+    const uint64_t *index;        // validation bitmap (see word_index.h), or NULL
+    const DictSchedule *schedule; // daily schedule (see daily.c), or NULL
+    const uint32_t *schedule_order;
+    size_t count;
+    int word_length;              // WORD_LENGTH unless written by dict_write_variant
+    void *map;
+    size_t map_size;
+} DictView;
+
+// Function declarations
+bool dict_is_binary(const void *data, size_t size);
+bool dict_map(const char *path, DictView *view);
+bool dict_view(const void *data, size_t size, DictView *view);
+void dict_unmap(DictView *view);
+bool dict_write(const char *path, const uint32_t *packed, size_t count, unsigned int flags,
+                const DictSchedule *schedule);
+bool dict_read_word(int fd, const DictHeader *header, size_t index, uint32_t *packed);
+bool dict_write_variant(const char *path, const uint64_t *packed, size_t count, int length);
+
+static inline size_t dict_schedule_offset(const DictHeader *header) {
+    return ((size_t)header->words_offset + header->words_size + 7) & ~(size_t)7;
+}
+
+// Reads the eight stream bytes holding the record that starts at `bit`.
+// Writers pad the section so this never runs past it.
+static inline uint64_t dict_chunk(const DictView *view, size_t bit) {
+    const uint8_t *p = view->words + bit / 8;
+    uint64_t chunk = 0;
+    for (int i = 0; i < 8; i++) {
+        chunk |= (uint64_t)p[i] << (8 * i);
+    }
+    return chunk >> (bit % 8);
+}
+
+// Extracts word `index` from a 5-letter dictionary's bit stream
+static inline uint32_t dict_word(const DictView *view, size_t index) {
+    return (uint32_t)dict_chunk(view, index * DICT_WORD_BITS) & ((1u << DICT_WORD_BITS) - 1);
+}
+
+// Extracts word `index` from a dictionary of any supported length
+static inline uint64_t dict_variant_word(const DictView *view, size_t index) {
+    unsigned int bits = LETTER_BITS * (unsigned int)view->word_length;
+    return dict_chunk(view, index * bits) & ((UINT64_C(1) << bits) - 1);
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * File: game.c
+ * Description: Reentrant game-state API.
+ *
+ *   A WordleGame holds everything about one game: the secret, the attempt
+ *   count, the guess/pattern history and the hint constraints that hard
+ *   mode enforces. The interactive loop, the server
+ *   sessions and the simulator all drive games through these functions.
+ */
+
+#include <string.h>
+#include "score.h"
+#include "game.h"
+#include "metrics.h"
+
+void game_init(const WordList *words, Rng *rng, WordleGame *game) {
+    game_init_with_secret(words, (size_t)rng_bounded(rng, words->answer_count), game);
+    metrics_add(METRIC_SECRETS_CHOSEN, 1);
+}
+
+void game_init_with_secret(const WordList *words, size_t secret, WordleGame *game) {
+    game_init_packed(secret, words->packed[secret], game);
+    game->words = words;
+}
+
+// Starts a game on a secret read straight from the dictionary file (see
+// startup.c), before or without loading the list itself
+void game_init_packed(size_t secret, uint32_t secret_packed, WordleGame *game) {
+    memset(game, 0, sizeof(*game));
+    game->secret = (uint32_t)secret;
+    game->secret_packed = secret_packed;
+    game->status = GAME_PLAYING;
+    constraints_init(&game->constraints);
+}
+
+// Restricts guesses to the words in `valid`; a new game starts unrestricted
+void game_set_word_index(WordleGame *game, const WordIndex *valid) {
+    game->valid = valid;
+}
+
+void game_set_hard_mode(WordleGame *game, bool hard) {
+    game->hard = hard;
+}
+
+// Plays the day's shared secret; words may be NULL as for game_init_packed
+void game_init_daily(const WordList *words, const DailySecret *daily, WordleGame *game) {
+    game_init_packed(daily->secret, daily->secret_packed, game);
+    game->words = words;
+    game->prepared = &daily->prepared;
+    game->daily = true;
+}
+
+GuessResult game_submit(WordleGame *game, const char *guess, uint8_t *pattern) {
+    if (strlen(guess) != WORD_LENGTH) {
+        return GUESS_WRONG_LENGTH;
+    }
+    return game_submit_packed(game, pack_word(guess), pattern);
+}
+
+GuessResult game_submit_packed(WordleGame *game, uint32_t guess, uint8_t *pattern) {
+    if (game->status != GAME_PLAYING) {
+        return GUESS_GAME_OVER;
+    }
+    if (game->valid != NULL) {
+        if (!word_index_contains(game->valid, guess)) {
+            metrics_add(METRIC_VALIDATION_MISSES, 1);
+            return GUESS_NOT_IN_LIST;
+        }
+        metrics_add(METRIC_VALIDATION_HITS, 1);
+    }
+    if (game->hard && !constraints_allows_guess(&game->constraints, guess)) {
+        return GUESS_BREAKS_HARD_MODE;
+    }
+
+    uint64_t start = metrics_sample_start();
+    *pattern = game->prepared != NULL ? score_prepared(game->prepared, guess)
+                                      : score_packed(game->secret_packed, guess);
+    metrics_sample_end(HISTOGRAM_CHECK_GUESS, start);
+    metrics_add(METRIC_GUESSES_SCORED, 1);
+    game->guesses[game->attempts] = guess;
+    game->patterns[game->attempts] = *pattern;
+    game->attempts++;
+    constraints_update(&game->constraints, guess, *pattern);
+
+    if (*pattern == PATTERN_SOLVED) {
+        game->status = GAME_WON;
+        metrics_add(METRIC_GAMES_WON, 1);
+    } else if (game->attempts >= MAX_ATTEMPTS) {
+        game->status = GAME_LOST;
+        metrics_add(METRIC_GAMES_LOST, 1);
+    }
+
+    return GUESS_ACCEPTED;
+}
+
+GameStatus game_status(const WordleGame *game) {
+    return (GameStatus)game->status;
+}
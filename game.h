@@ -0,0 +1,59 @@
+// game.h
+
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "wordlist.h"
+#include "word_index.h"
+#include "constraints.h"
+#include "rng.h"
+#include "daily.h"
+
+typedef enum {
+    GAME_PLAYING,
+    GAME_WON,
+    GAME_LOST
+} GameStatus;
+
+typedef enum {
+    GUESS_ACCEPTED,
+    GUESS_WRONG_LENGTH,
+    GUESS_NOT_IN_LIST,
+    GUESS_BREAKS_HARD_MODE,
+    GUESS_GAME_OVER
+} GuessResult;
+
+// One game in progress. The struct is self-contained: it never allocates,
+// refers to no global state, and the word list it points at is only read,
+// so any number of games can run concurrently on different threads.
+typedef struct {
+    const WordList *words;      // NULL after game_init_packed
+    const WordIndex *valid;     // accepted guesses, NULL to accept any letters
+    uint32_t secret;            // index into words
+    uint32_t secret_packed;
+    const PreparedSecret *prepared; // shared scoring tables, or NULL
+    uint8_t attempts;
+    uint8_t status;             // GameStatus
+    bool hard;                  // guesses must reuse every revealed hint
+    bool daily;                 // started by game_init_daily
+    Constraints constraints;    // what the feedback so far reveals
+    uint32_t guesses[MAX_ATTEMPTS];
+    uint8_t patterns[MAX_ATTEMPTS];
+} WordleGame;
+
+// Function declarations
+void game_init(const WordList *words, Rng *rng, WordleGame *game);
+void game_init_with_secret(const WordList *words, size_t secret, WordleGame *game);
+void game_init_packed(size_t secret, uint32_t secret_packed, WordleGame *game);
+void game_init_daily(const WordList *words, const DailySecret *daily, WordleGame *game);
+void game_set_word_index(WordleGame *game, const WordIndex *valid);
+void game_set_hard_mode(WordleGame *game, bool hard);
+GuessResult game_submit(WordleGame *game, const char *guess, uint8_t *pattern);
+GuessResult game_submit_packed(WordleGame *game, uint32_t guess, uint8_t *pattern);
+GameStatus game_status(const WordleGame *game);
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * File: gamelog.c
+ * Description: Append-only binary log of completed games.
+ *
+ *   Every finished game, interactive, served or simulated, can be written
+ *   as one fixed-size GameRecord: the secret, the guesses and their
+ *   patterns, 36 bytes in all. Records are gathered per thread in a
+ *   GameLogWriter and written GAMELOG_BATCH at a time, so a simulation
+ *   logging a million games makes a few thousand write calls and takes no
+ *   lock. The file is opened O_APPEND: each flush lands whole at the end
+ *   even with several threads or processes logging to the same file.
+ *
+ *   Readers map the file and index the records directly (see
+ *   tools/wordle_logq.c); nothing has to be parsed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gamelog.h"
+#include "metrics.h"
+
+// Names the problem with a header that does not match
+static void report_header(const char *path, const GameLogHeader *header) {
+    if (memcmp(header->magic, GAMELOG_MAGIC, 4) == 0 && header->version == GAMELOG_VERSION_SWAPPED) {
+        fprintf(stderr, "%s was written on a machine of the other byte order.\n", path);
+    } else {
+        fprintf(stderr, "%s is not a game log of this version.\n", path);
+    }
+}
+
+static bool header_matches(const GameLogHeader *header) {
+    return memcmp(header->magic, GAMELOG_MAGIC, 4) == 0 && header->version == GAMELOG_VERSION &&
+           header->word_length == WORD_LENGTH && header->record_size == sizeof(GameRecord);
+}
+
+static bool write_all(int fd, const void *data, size_t length) {
+    const char *p = data;
+    while (length > 0) {
+        ssize_t written = write(fd, p, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+// Creates the log with its header, or checks the header of an existing
+// one. The lock keeps two processes from both writing a header.
+bool gamelog_open(const char *path, GameLog *log) {
+    log->fd = -1;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror("Failed to open game log");
+        return false;
+    }
+    flock(fd, LOCK_EX);
+
+    bool ok = false;
+    struct stat st;
+    GameLogHeader header;
+    memset(&header, 0, sizeof(header));
+    if (fstat(fd, &st) != 0) {
+        perror("Failed to open game log");
+    } else if (st.st_size == 0) {
+        memcpy(header.magic, GAMELOG_MAGIC, 4);
+        header.version = GAMELOG_VERSION;
+        header.word_length = WORD_LENGTH;
+        header.record_size = sizeof(GameRecord);
+        ok = write_all(fd, &header, sizeof(header));
+        if (!ok) {
+            perror("Failed to write game log");
+        }
+    } else if ((size_t)st.st_size < sizeof(header) || pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+               !header_matches(&header)) {
+        report_header(path, &header);
+    } else {
+        // Only a writer that died mid-flush leaves part of a record; cut it
+        // off so the next records stay aligned
+        size_t torn = ((size_t)st.st_size - sizeof(header)) % sizeof(GameRecord);
+        ok = torn == 0 || ftruncate(fd, st.st_size - (off_t)torn) == 0;
+        if (!ok) {
+            perror("Failed to repair game log");
+        }
+    }
+
+    flock(fd, LOCK_UN);
+    if (!ok) {
+        close(fd);
+        return false;
+    }
+    log->fd = fd;
+    return true;
+}
+
+void gamelog_close(GameLog *log) {
+    if (log->fd >= 0) {
+        close(log->fd);
+    }
+    log->fd = -1;
+}
+
+void gamelog_writer_init(GameLogWriter *writer, GameLog *log) {
+    writer->log = log;
+    writer->count = 0;
+}
+
+// Queues a finished game; `source` is one of the GAMELOG_* sources
+void gamelog_append(GameLogWriter *writer, const WordleGame *game, unsigned int source) {
+    if (writer->count == GAMELOG_BATCH) {
+        gamelog_flush(writer);
+    }
+
+    GameRecord *record = &writer->records[writer->count++];
+    memset(record, 0, sizeof(*record));
+    record->secret = game->secret_packed;
+    memcpy(record->guesses, game->guesses, game->attempts * sizeof(record->guesses[0]));
+    memcpy(record->patterns, game->patterns, game->attempts);
+    record->attempts = game->attempts;
+    record->flags = (uint8_t)(source & GAMELOG_SOURCE_MASK);
+    if (game->status == GAME_WON) {
+        record->flags |= GAMELOG_WON;
+    }
+    if (game->hard) {
+        record->flags |= GAMELOG_HARD;
+    }
+    if (game->daily) {
+        record->flags |= GAMELOG_DAILY;
+    }
+}
+
+// Writes the queued records in one call; a failed write drops them, since
+// losing log lines must never stop a game
+void gamelog_flush(GameLogWriter *writer) {
+    if (writer->count == 0) {
+        return;
+    }
+    if (write_all(writer->log->fd, writer->records, writer->count * sizeof(GameRecord))) {
+        metrics_add(METRIC_GAMES_LOGGED, writer->count);
+    } else {
+        perror("Failed to write game log");
+    }
+    writer->count = 0;
+}
+
+bool gamelog_map(const char *path, GameLogView *view) {
+    memset(view, 0, sizeof(*view));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open game log");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(GameLogHeader)) {
+        fprintf(stderr, "%s is not a game log.\n", path);
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("Failed to map game log");
+        return false;
+    }
+    if (!header_matches(map)) {
+        report_header(path, map);
+        munmap(map, size);
+        return false;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    // A record still being appended is left out
+    view->records = (const GameRecord *)((const char *)map + sizeof(GameLogHeader));
+    view->count = (size - sizeof(GameLogHeader)) / sizeof(GameRecord);
+    view->map = map;
+    view->map_size = size;
+    return true;
+}
+
+void gamelog_unmap(GameLogView *view) {
+    if (view->map != NULL) {
+        munmap(view->map, view->map_size);
+    }
+    memset(view, 0, sizeof(*view));
+}
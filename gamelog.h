@@ -0,0 +1,80 @@
+// gamelog.h
+
+#ifndef GAMELOG_H
+#define GAMELOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "game.h"
+
+#define GAMELOG_MAGIC "WLOG"
+#define GAMELOG_VERSION 1
+// The version field as a machine of the other byte order reads it
+#define GAMELOG_VERSION_SWAPPED ((uint32_t)GAMELOG_VERSION << 24)
+
+// Records a writer gathers before one write(2)
+#define GAMELOG_BATCH 128
+
+// Record flags; the low two bits name where the game was played
+#define GAMELOG_SOURCE_MASK 0x03
+#define GAMELOG_INTERACTIVE 0x00
+#define GAMELOG_SERVER 0x01
+#define GAMELOG_SIMULATED 0x02
+#define GAMELOG_WON 0x04
+#define GAMELOG_HARD 0x08
+#define GAMELOG_DAILY 0x10
+
+// On-disk layout: this header, then fixed-size records back to back in
+// the order they were flushed. Records are written as the machine holds
+// them, so a log only reads back on a machine of the same byte order;
+// readers of the other order see GAMELOG_VERSION_SWAPPED and refuse it.
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t word_length;
+    uint32_t record_size;       // sizeof(GameRecord)
+} GameLogHeader;
+
+// One completed game. Words are packed (see pack_word), so a record means
+// the same thing whichever list or dictionary the game was played from;
+// guesses and patterns past `attempts` are zero.
+typedef struct {
+    uint32_t secret;
+    uint32_t guesses[MAX_ATTEMPTS];
+    uint8_t patterns[MAX_ATTEMPTS];
+    uint8_t attempts;
+    uint8_t flags;
+} GameRecord;
+
+// An open log, shared by every writer in the process
+typedef struct {
+    int fd;
+} GameLog;
+
+// One thread's batch of records not yet written
+typedef struct {
+    GameLog *log;
+    size_t count;
+    GameRecord records[GAMELOG_BATCH];
+} GameLogWriter;
+
+// A mapped log; records holds every complete record in the file
+typedef struct {
+    const GameRecord *records;
+    size_t count;
+    void *map;
+    size_t map_size;
+} GameLogView;
+
+// Function declarations
+bool gamelog_open(const char *path, GameLog *log);
+void gamelog_close(GameLog *log);
+void gamelog_writer_init(GameLogWriter *writer, GameLog *log);
+void gamelog_append(GameLogWriter *writer, const WordleGame *game, unsigned int source);
+void gamelog_flush(GameLogWriter *writer);
+bool gamelog_map(const char *path, GameLogView *view);
+void gamelog_unmap(GameLogView *view);
+
+#endif
@@ -0,0 +1,658 @@
+/*
+ * File: main.c
+ * Description: Entry point for the Wordle game and its batch modes.
+ *
+ * Usage:
+ *   - Run `./wordle` and follow the prompts to guess the secret word.
+ *     `--no-color` prints plain-text rows, `--emoji` prints coloured squares,
+ *     and `--share` prints an emoji grid of the finished game.
+ *   - Run `./wordle --build-matrix [--threads N]` to precompute the guess x secret pattern cache.
+ *   - Run `./wordle --build-strategy [--hard]` to precompute the solver's decision tree;
+ *     `--hints` then shows its next guess before every prompt (see strategy.c).
+ *   - Run `./wordle --build-offsets` to index a text list's lines, so that
+ *     starting a game reads one word instead of the whole list (see startup.c).
+ *   - Run `./wordle --solve [WORD]` to watch the built-in solver play (see solver.c).
+ *   - Run `./wordle --simulate-all [--sample N] [--threads N]` to benchmark the solver on the whole list.
+ *   - Run `./wordle --rank-openers [--top K] [--rank-by entropy|remaining] [--checkpoint FILE]`
+ *     to score every word as a first guess (see openers.c).
+ *   - Run `./wordle --server [--listen SPEC] [--threads N]` to serve many games over sockets (see server.c);
+ *     SIGHUP reloads its dictionaries in place (see registry.c).
+ *   - Run `./wordle --score-stream [--binary] < pairs` to score "secret guess" lines from
+ *     stdin to stdout without any word list (see stream.c).
+ *   - Run `./wordle --words FILE.dict --daily [--date YYYY-MM-DD]` to play the word of
+ *     the day from a dictionary packed with --with-schedule (see daily.c).
+ *   - Pass `--hard` to play, solve or simulate by hard-mode rules: every
+ *     guess must keep the greens in place and reuse the yellows.
+ *   - Pass `--seed N` to make secrets and samples reproducible.
+ *   - Pass `--log FILE` to append every finished game, played, served or
+ *     simulated, to a binary game log that `wordle-logq` queries (see gamelog.c).
+ *   - Pass `--metrics` to print the run's counters and latency histograms
+ *     to stderr on exit; servers answer the METRICS command (see metrics.c).
+ *   - Pass `--words FILE` to play from another list, either plain text or a
+ *     binary dictionary compiled with `wordle-pack`. Lists of 4-, 6- and
+ *     7-letter words play the variant game (see variant.c).
+ *   - Pass `--answers FILE` to draw secrets from a smaller answer list while
+ *     `--words` lists every allowed guess; the matrix, solver, simulations
+ *     and rankings then work on guesses x answers. `--server` also takes
+ *     `--dict NAME=ANSWERS[:GUESSES]`, repeatable, for "NEW NAME" (see
+ *     registry.c).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "wordle.h"
+#include "score.h"
+#include "matrix.h"
+#include "wordlist.h"
+#include "solver.h"
+#include "simulate.h"
+#include "server.h"
+#include "word_index.h"
+#include "variant.h"
+#include "arena.h"
+#include "openers.h"
+#include "stream.h"
+#include "strategy.h"
+#include "game.h"
+#include "rng.h"
+#include "render.h"
+#include "timing.h"
+#include "metrics.h"
+#include "startup.h"
+#include "daily.h"
+#include "registry.h"
+#include "gamelog.h"
+
+// --answers separates the possible secrets from the allowed guesses, which
+// then come from --words
+static bool load_words(const char *words_file, const char *answers_file, WordList *list) {
+    return answers_file != NULL ? wordlist_load_split(answers_file, words_file, list)
+                                : wordlist_load(words_file, list);
+}
+
+static int build_matrix(const char *words_file, const char *answers_file, int threads) {
+    WordList list;
+    PatternMatrix matrix;
+
+    if (!load_words(words_file, answers_file, &list)) {
+        return EXIT_FAILURE;
+    }
+    if (threads <= 0) {
+        threads = default_thread_count();
+    }
+
+    // Always rebuild so a stale or corrupt cache gets replaced
+    uint64_t start = monotonic_ns();
+    matrix_build(list.packed, list.count, list.answer_count, threads, &matrix);
+    double seconds = elapsed_seconds(start);
+
+    double pairs = (double)list.count * list.answer_count;
+    printf("Scored %.0f pairs on %d thread%s in %.3f s (%.1f M pairs/s).\n",
+           pairs, threads, threads == 1 ? "" : "s", seconds, pairs / seconds / 1e6);
+
+    bool saved = matrix_save(PATTERN_CACHE_FILE, &matrix);
+    if (saved) {
+        printf("Wrote %zu x %zu pattern matrix to %s.\n", list.count, list.answer_count, PATTERN_CACHE_FILE);
+    }
+
+    matrix_free(&matrix);
+    wordlist_free(&list);
+    return saved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int build_strategy(const char *words_file, const char *answers_file, const char *path, bool hard) {
+    WordList list;
+    PatternMatrix matrix;
+
+    if (!load_words(words_file, answers_file, &list)) {
+        return EXIT_FAILURE;
+    }
+    matrix_open(PATTERN_CACHE_FILE, list.packed, list.count, list.answer_count, &matrix);
+
+    uint64_t start = monotonic_ns();
+    bool ok = strategy_build(&list, &matrix, hard, path);
+    if (ok) {
+        printf("Built the strategy tree in %.3f s.\n", elapsed_seconds(start));
+    }
+
+    matrix_free(&matrix);
+    wordlist_free(&list);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Index of an answer, or SOLVER_NO_GUESS
+static size_t find_answer(const WordList *list, const char *word) {
+    uint32_t packed = pack_word(word);
+    for (size_t i = 0; i < list->answer_count; i++) {
+        if (list->packed[i] == packed) {
+            return i;
+        }
+    }
+    return SOLVER_NO_GUESS;
+}
+
+static int solve_word(const char *words_file, const char *answers_file, const char *target, bool hard) {
+    WordList list;
+    if (!load_words(words_file, answers_file, &list)) {
+        return EXIT_FAILURE;
+    }
+
+    size_t secret = target != NULL && strlen(target) == WORD_LENGTH
+                        ? find_answer(&list, target)
+                        : (size_t)rng_bounded(rng_thread(), list.answer_count);
+    if (target != NULL && secret == SOLVER_NO_GUESS) {
+        fprintf(stderr, "'%s' is not in the answer list.\n", target);
+        wordlist_free(&list);
+        return EXIT_FAILURE;
+    }
+
+    PatternMatrix matrix;
+    PatternIndex index;
+    Solver solver;
+    Arena *arena = arena_thread();
+    ArenaMark start = arena_mark(arena);
+    matrix_open(PATTERN_CACHE_FILE, list.packed, list.count, list.answer_count, &matrix);
+    pattern_index_init(&index, &matrix, pattern_index_capacity_for(&matrix, PATTERN_INDEX_BUDGET));
+    solver_init(&solver, &list, &matrix, arena);
+    solver_attach_index(&solver, &index);
+    solver_set_hard_mode(&solver, hard);
+
+    bool solved = false;
+    for (int attempt = 1; attempt <= MAX_ATTEMPTS && !solved; attempt++) {
+        size_t guess = solver_next_guess(&solver);
+        uint8_t pattern = matrix_lookup(&matrix, guess, secret);
+        char word[WORD_LENGTH + 1];
+        int scores[WORD_LENGTH];
+
+        unpack_word(list.packed[guess], word);
+        pattern_to_scores(pattern, scores);
+        printf("Attempt %d of %d: %s (%zu possible)\n", attempt, MAX_ATTEMPTS, word, solver.remaining);
+        display_result(word, scores);
+
+        solver_apply(&solver, guess, pattern);
+        solved = pattern == PATTERN_SOLVED;
+    }
+
+    printf(solved ? "Solved!\n" : "The solver ran out of attempts.\n");
+
+    solver_free(&solver);
+    arena_release(arena, start);
+    pattern_index_free(&index);
+    matrix_free(&matrix);
+    wordlist_free(&list);
+    return solved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int simulate(const char *words_file, const char *answers_file, const SimulateOptions *options) {
+    WordList list;
+    if (!load_words(words_file, answers_file, &list)) {
+        return EXIT_FAILURE;
+    }
+
+    PatternMatrix matrix;
+    matrix_open(PATTERN_CACHE_FILE, list.packed, list.count, list.answer_count, &matrix);
+    int status = simulate_all(&list, &matrix, options);
+
+    matrix_free(&matrix);
+    wordlist_free(&list);
+    return status;
+}
+
+// The --words/--answers pair is the default dictionary; every --dict
+// adds one that "NEW NAME" can pick. SIGHUP reloads them all.
+static int serve(const char *words_file, const char *answers_file, const char **dict_specs, size_t dict_count,
+                 const char *strategy_path, const ServerOptions *options) {
+    DictRegistry registry;
+    registry_init(&registry);
+
+    // HINT works only when a strategy tree has been built for this list
+    const char *secrets_file = answers_file != NULL ? answers_file : words_file;
+    const Dictionary *dict = registry_add(&registry, REGISTRY_DEFAULT_NAME, secrets_file,
+                                          answers_file != NULL ? words_file : NULL, strategy_path);
+    for (size_t i = 0; i < dict_count && dict != NULL; i++) {
+        if (registry_add_spec(&registry, dict_specs[i]) == NULL) {
+            dict = NULL;
+        }
+    }
+    if (dict == NULL) {
+        registry_free(&registry);
+        return EXIT_FAILURE;
+    }
+
+    // DAILY works only when the dictionary carries a schedule
+    DailySchedule schedule;
+    bool have_daily = daily_has_schedule(secrets_file) && daily_open(secrets_file, &schedule);
+
+    int status = server_run(&registry, have_daily ? &schedule : NULL, options);
+
+    if (have_daily) {
+        daily_close(&schedule);
+    }
+    registry_free(&registry);
+    return status;
+}
+
+static int rank(const char *words_file, const char *answers_file, const RankOptions *options) {
+    WordList list;
+    if (!load_words(words_file, answers_file, &list)) {
+        return EXIT_FAILURE;
+    }
+
+    int status = rank_openers(&list, options);
+
+    wordlist_free(&list);
+    return status;
+}
+
+static int score_pairs_stream(const StreamOptions *options) {
+    StreamStats stats;
+    uint64_t start = monotonic_ns();
+
+    int status = score_stream(STDIN_FILENO, STDOUT_FILENO, options, &stats);
+
+    double seconds = elapsed_seconds(start);
+    fprintf(stderr, "Scored %llu pairs (%llu invalid) in %.3f s, %.1f M pairs/s\n",
+            (unsigned long long)stats.pairs, (unsigned long long)stats.invalid, seconds,
+            seconds > 0 ? stats.pairs / seconds / 1e6 : 0.0);
+    return status;
+}
+
+static void print_metrics(void) {
+    size_t length;
+    char *text = metrics_format_alloc(&length);
+    if (text != NULL) {
+        render_emit(STDERR_FILENO, text, length);
+        free(text);
+    }
+}
+
+static void show_row(const char *guess, uint8_t pattern, RenderMode mode) {
+    if (mode == RENDER_COLOR) {
+        int scores[WORD_LENGTH];
+        pattern_to_scores(pattern, scores);
+        display_result(guess, scores);
+        return;
+    }
+
+    char line[sizeof("Result: ") - 1 + RENDER_ROW_MAX];
+    size_t length = sizeof("Result: ") - 1;
+    memcpy(line, "Result: ", length);
+    length += render_row(line + length, guess, pattern, mode);
+    fflush(stdout);
+    render_emit(STDOUT_FILENO, line, length);
+}
+
+static int play(LazyWords *words, const DailySecret *daily, const Strategy *strategy, bool hard,
+                RenderMode mode, bool share, GameLog *log) {
+    WordleGame game;
+    char guess[64];
+    uint8_t pattern;
+    size_t secret;
+    uint32_t secret_packed;
+
+    // The secret comes straight from the file when it allows; the list and
+    // the validation index wait for the first guess (see startup.c)
+    if (daily != NULL) {
+        game_init_daily(NULL, daily, &game);
+    } else if (startup_pick_secret(words->answers_file != NULL ? words->answers_file : words->words_file,
+                                   rng_thread(), &secret, &secret_packed)) {
+        game_init_packed(secret, secret_packed, &game);
+        metrics_add(METRIC_SECRETS_CHOSEN, 1);
+    } else {
+        const WordList *list = lazy_words_list(words);
+        if (list == NULL) {
+            return EXIT_FAILURE;
+        }
+        game_init(list, rng_thread(), &game);
+    }
+    game_set_hard_mode(&game, hard);
+
+    printf("Welcome to Wordle!\n");
+    if (daily != NULL) {
+        printf("Daily puzzle #%u.\n", daily->number);
+    }
+    printf("Guess the %d-letter word. You have %d attempts.\n", WORD_LENGTH, MAX_ATTEMPTS);
+
+    while (game_status(&game) == GAME_PLAYING) {
+        uint32_t hint = strategy != NULL ? strategy_hint(strategy, game.guesses, game.patterns, game.attempts)
+                                         : STRATEGY_NO_HINT;
+        if (hint != STRATEGY_NO_HINT) {
+            char word[WORD_LENGTH + 1];
+            unpack_word(hint, word);
+            printf("Hint: %s\n", word);
+        }
+        printf("Attempt %d of %d: ", game.attempts + 1, MAX_ATTEMPTS);
+        if (scanf("%63s", guess) != 1) {
+            printf("\n");
+            break;
+        }
+
+        const WordIndex *valid = lazy_words_index(words);
+        if (valid == NULL) {
+            return EXIT_FAILURE;
+        }
+        game_set_word_index(&game, valid);
+
+        // Ensure the guess is the correct length and a real word
+        GuessResult result = game_submit(&game, guess, &pattern);
+        if (result == GUESS_WRONG_LENGTH) {
+            printf("Please enter a %d-letter word.\n", WORD_LENGTH);
+            continue;
+        }
+        if (result == GUESS_NOT_IN_LIST) {
+            printf("Not in word list.\n");
+            continue;
+        }
+        if (result == GUESS_BREAKS_HARD_MODE) {
+            printf("Hard mode: reuse every revealed hint.\n");
+            continue;
+        }
+
+        show_row(guess, pattern, mode);
+    }
+
+    char secret_word[WORD_LENGTH + 1];
+    unpack_word(game.secret_packed, secret_word);
+    if (game_status(&game) == GAME_WON) {
+        printf("Congratulations! You've guessed the word!\n");
+    } else if (game_status(&game) == GAME_LOST) {
+        printf("Sorry, you've run out of attempts. The word was '%s'.\n", secret_word);
+    } else {
+        // Input ended mid-game
+        printf("The word was '%s'.\n", secret_word);
+    }
+
+    if (share && game_status(&game) != GAME_PLAYING) {
+        char grid[RENDER_BOARD_MAX];
+        size_t length = render_share(grid, game.patterns, game.attempts, game_status(&game) == GAME_WON);
+        fflush(stdout);
+        render_emit(STDOUT_FILENO, grid, length);
+    }
+
+    if (log != NULL && game_status(&game) != GAME_PLAYING) {
+        GameLogWriter writer;
+        gamelog_writer_init(&writer, log);
+        gamelog_append(&writer, &game, GAMELOG_INTERACTIVE);
+        gamelog_flush(&writer);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// Lists of any other length are played with the kernels from variant.c
+static int play_variant(const char *words_file, RenderMode mode) {
+    VariantList list;
+    if (!variant_list_load(words_file, &list)) {
+        return EXIT_FAILURE;
+    }
+
+    const WordVariant *variant = list.variant;
+    size_t secret = (size_t)rng_bounded(rng_thread(), list.count);
+    char guess[64];
+    int attempts = 0;
+    bool won = false;
+
+    printf("Welcome to Wordle!\n");
+    printf("Guess the %d-letter word. You have %d attempts.\n", variant->length, variant->max_attempts);
+
+    while (attempts < variant->max_attempts && !won) {
+        printf("Attempt %d of %d: ", attempts + 1, variant->max_attempts);
+        if (scanf("%63s", guess) != 1) {
+            printf("\n");
+            break;
+        }
+
+        if (strlen(guess) != (size_t)variant->length) {
+            printf("Please enter a %d-letter word.\n", variant->length);
+            continue;
+        }
+        uint64_t packed = variant->pack(guess);
+        if (!variant_list_contains(&list, packed)) {
+            printf("Not in word list.\n");
+            continue;
+        }
+
+        uint16_t pattern = variant->score(list.packed[secret], packed);
+        char line[sizeof("Result: ") - 1 + RENDER_VARIANT_ROW_MAX];
+        size_t length = sizeof("Result: ") - 1;
+        memcpy(line, "Result: ", length);
+        length += render_row_variant(line + length, guess, variant->length, pattern, mode);
+        fflush(stdout);
+        render_emit(STDOUT_FILENO, line, length);
+
+        attempts++;
+        won = pattern == variant->pattern_solved;
+    }
+
+    const char *word = variant_list_word(&list, secret);
+    if (won) {
+        printf("Congratulations! You've guessed the word!\n");
+    } else if (attempts >= variant->max_attempts) {
+        printf("Sorry, you've run out of attempts. The word was '%.*s'.\n", variant->length, word);
+    } else {
+        printf("The word was '%.*s'.\n", variant->length, word);
+    }
+
+    variant_list_free(&list);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    const char *words_file = WORD_LIST_FILE;
+    const char *answers_file = NULL;
+    const char *dict_specs[REGISTRY_MAX_DICTIONARIES];
+    size_t dict_count = 0;
+    const char *solve_target = NULL;
+    int threads = 0;
+    bool want_matrix = false;
+    bool want_solve = false;
+    bool want_simulate = false;
+    bool want_server = false;
+    bool want_rank = false;
+    bool want_strategy = false;
+    bool want_stream = false;
+    bool want_offsets = false;
+    bool daily = false;
+    int64_t daily_day = 0;
+    bool have_date = false;
+    bool hints = false;
+    const char *strategy_path = STRATEGY_FILE;
+    const char *log_path = NULL;
+    bool share = false;
+    bool hard = false;
+    RenderMode mode = RENDER_COLOR;
+    SimulateOptions simulate_options = {0, 0, false, NULL};
+    RankOptions rank_options = {0, 0, RANK_BY_ENTROPY, NULL};
+    StreamOptions stream_options = {STREAM_TEXT, 0};
+    ServerOptions server_options = {SERVER_DEFAULT_LISTEN, 0, SERVER_DEFAULT_MAX_SESSIONS, NULL};
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--build-matrix") == 0) {
+            want_matrix = true;
+        } else if (strcmp(argv[i], "--build-offsets") == 0) {
+            want_offsets = true;
+        } else if (strcmp(argv[i], "--build-strategy") == 0) {
+            want_strategy = true;
+        } else if (strcmp(argv[i], "--strategy") == 0 && i + 1 < argc) {
+            strategy_path = argv[++i];
+        } else if (strcmp(argv[i], "--hints") == 0) {
+            hints = true;
+        } else if (strcmp(argv[i], "--solve") == 0) {
+            want_solve = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                solve_target = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--simulate-all") == 0) {
+            want_simulate = true;
+        } else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc) {
+            simulate_options.sample = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--rank-openers") == 0) {
+            want_rank = true;
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            rank_options.top = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--rank-by") == 0 && i + 1 < argc &&
+                   (strcmp(argv[i + 1], "entropy") == 0 || strcmp(argv[i + 1], "remaining") == 0)) {
+            rank_options.rank_by = strcmp(argv[++i], "entropy") == 0 ? RANK_BY_ENTROPY : RANK_BY_REMAINING;
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            rank_options.checkpoint = argv[++i];
+        } else if (strcmp(argv[i], "--score-stream") == 0) {
+            want_stream = true;
+        } else if (strcmp(argv[i], "--binary") == 0) {
+            stream_options.format = STREAM_BINARY;
+        } else if (strcmp(argv[i], "--server") == 0) {
+            want_server = true;
+        } else if (strcmp(argv[i], "--listen") == 0 && i + 1 < argc) {
+            server_options.listen = argv[++i];
+        } else if (strcmp(argv[i], "--max-sessions") == 0 && i + 1 < argc) {
+            server_options.max_sessions = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--no-color") == 0) {
+            mode = RENDER_PLAIN;
+        } else if (strcmp(argv[i], "--emoji") == 0) {
+            mode = RENDER_EMOJI;
+        } else if (strcmp(argv[i], "--daily") == 0) {
+            daily = true;
+        } else if (strcmp(argv[i], "--date") == 0 && i + 1 < argc) {
+            if (!daily_parse_date(argv[++i], &daily_day)) {
+                fprintf(stderr, "Invalid date '%s'; expected YYYY-MM-DD.\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            have_date = true;
+        } else if (strcmp(argv[i], "--hard") == 0) {
+            hard = true;
+        } else if (strcmp(argv[i], "--share") == 0) {
+            share = true;
+        } else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            log_path = argv[++i];
+        } else if (strcmp(argv[i], "--metrics") == 0) {
+            atexit(print_metrics);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            rng_set_process_seed(strtoull(argv[++i], NULL, 10));
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            words_file = argv[++i];
+        } else if (strcmp(argv[i], "--answers") == 0 && i + 1 < argc) {
+            answers_file = argv[++i];
+        } else if (strcmp(argv[i], "--dict") == 0 && i + 1 < argc && dict_count < REGISTRY_MAX_DICTIONARIES - 1) {
+            dict_specs[dict_count++] = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--words FILE] [--answers FILE] [--threads N] [--seed N] [--hard] [--no-color | --emoji] [--share] [--metrics]\n"
+                            "       [--log FILE] [--strategy FILE] [--hints] [--daily [--date YYYY-MM-DD]]\n"
+                            "       [--build-matrix | --build-strategy | --build-offsets | --solve [WORD] | --simulate-all [--sample N] |\n"
+                            "        --rank-openers [--top K] [--rank-by entropy|remaining] [--checkpoint FILE] |\n"
+                            "        --server [--listen PORT|HOST:PORT|unix:PATH] [--max-sessions N] [--dict NAME=ANSWERS[:GUESSES]]... |\n"
+                            "        --score-stream [--binary]]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Streamed pairs carry their own words, so no list is loaded
+    if (want_stream) {
+        return score_pairs_stream(&stream_options);
+    }
+
+    // The dictionary header (or the first line of a text list) decides
+    // which word length this run plays
+    int length = variant_detect_length(words_file);
+    if (length != WORD_LENGTH && word_variant(length) != NULL) {
+        if (want_matrix || want_offsets || want_server || want_simulate || want_solve || want_rank || want_strategy ||
+            hard || share || hints || daily || answers_file != NULL || log_path != NULL) {
+            fprintf(stderr, "%d-letter lists support only the plain interactive game.\n", length);
+            return EXIT_FAILURE;
+        }
+        return play_variant(words_file, mode);
+    }
+
+    // Secrets, daily schedules and the startup offsets come from the
+    // answer list when there is one
+    const char *secrets_file = answers_file != NULL ? answers_file : words_file;
+
+    // Playing, serving and simulating log their finished games; the file
+    // is closed when the process exits
+    GameLog log;
+    GameLog *game_log = NULL;
+    if (log_path != NULL) {
+        if (!gamelog_open(log_path, &log)) {
+            return EXIT_FAILURE;
+        }
+        game_log = &log;
+    }
+
+    if (want_matrix) {
+        return build_matrix(words_file, answers_file, threads);
+    }
+    if (want_offsets) {
+        return startup_write_offsets(secrets_file);
+    }
+    if (want_strategy) {
+        return build_strategy(words_file, answers_file, strategy_path, hard);
+    }
+    if (want_rank) {
+        rank_options.threads = threads;
+        return rank(words_file, answers_file, &rank_options);
+    }
+    if (want_server) {
+        server_options.threads = threads;
+        server_options.log = game_log;
+        return serve(words_file, answers_file, dict_specs, dict_count, strategy_path, &server_options);
+    }
+    if (want_simulate) {
+        simulate_options.threads = threads;
+        simulate_options.hard = hard;
+        simulate_options.log = game_log;
+        return simulate(words_file, answers_file, &simulate_options);
+    }
+    if (want_solve) {
+        return solve_word(words_file, answers_file, solve_target, hard);
+    }
+
+    LazyWords words;
+    lazy_words_init(&words, words_file, answers_file);
+
+    DailySchedule schedule;
+    const DailySecret *secret = NULL;
+    if (daily) {
+        if (!daily_open(secrets_file, &schedule)) {
+            return EXIT_FAILURE;
+        }
+        secret = daily_secret(&schedule, have_date ? daily_day : daily_today());
+        if (secret == NULL) {
+            fprintf(stderr, "That date is before the first daily puzzle.\n");
+            daily_close(&schedule);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Hints show before the first prompt, so they load the list up front
+    Strategy strategy;
+    bool have_strategy = false;
+    if (hints) {
+        const WordList *list = lazy_words_list(&words);
+        if (list == NULL) {
+            return EXIT_FAILURE;
+        }
+        have_strategy = strategy_load(strategy_path, list, &strategy);
+        if (!have_strategy) {
+            printf("No strategy in %s; build one with --build-strategy. Playing without hints.\n", strategy_path);
+        } else if (hard && !(strategy.header->flags & STRATEGY_HARD_MODE)) {
+            printf("%s was built without --hard; playing without hints.\n", strategy_path);
+            strategy_free(&strategy);
+            have_strategy = false;
+        }
+    }
+
+    int status = play(&words, secret, have_strategy ? &strategy : NULL, hard, mode, share, game_log);
+
+    if (have_strategy) {
+        strategy_free(&strategy);
+    }
+    if (daily) {
+        daily_close(&schedule);
+    }
+
+    lazy_words_free(&words);
+    return status;
+}
@@ -0,0 +1,239 @@
+/*
+ * File: matrix.c
+ * Description: Precomputed guess x secret feedback table.
+ *
+ *   The table holds one pattern byte per (guess, answer) pair: about 1.9 MB
+ *   for the bundled 1367 words, where every word is both. With a separate
+ *   answer list (see wordlist_load_split) it is only guesses x answers,
+ *   which is all the solver ever reads, instead of guesses squared. It is
+ *   written to a small versioned cache file keyed by a hash of the packed
+ *   word list and the answer count, so later runs mmap it instead of
+ *   rescoring every pair. A cache built from a different list, word length
+ *   or format version is ignored and rebuilt.
+ *
+ *   Construction is split into blocks of rows that a small pool of pthreads
+ *   claims from a shared counter; every row is written by exactly one
+ *   worker, so the table is byte-identical to a single-threaded build.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "wordle.h"
+#include "score.h"
+#include "matrix.h"
+
+uint64_t hash_word_list(const uint32_t *words, size_t count) {
+    // 64-bit FNV-1a over the packed words
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < count; i++) {
+        for (int b = 0; b < 4; b++) {
+            hash ^= (words[i] >> (8 * b)) & 0xff;
+            hash *= 0x100000001b3ULL;
+        }
+    }
+
+    return hash;
+}
+
+// hash_word_list, with the answer count folded in when the list has
+// guess-only words; a single-file list hashes exactly as before, so the
+// caches keyed by it stay valid
+uint64_t hash_word_sets(const uint32_t *words, size_t count, size_t answer_count) {
+    uint64_t hash = hash_word_list(words, count);
+
+    if (answer_count != count) {
+        for (int b = 0; b < 4; b++) {
+            hash ^= (answer_count >> (8 * b)) & 0xff;
+            hash *= 0x100000001b3ULL;
+        }
+    }
+
+    return hash;
+}
+
+// Rows handed to a worker per grab; small enough to balance the tail,
+// large enough that the shared counter is not contended
+#define MATRIX_BLOCK_ROWS 16
+
+typedef struct {
+    const uint32_t *words;
+    size_t count;
+    size_t answer_count;
+    uint8_t *cells;
+    atomic_size_t next_row;
+} MatrixBuildJob;
+
+static void build_rows(const MatrixBuildJob *job, size_t first, size_t last) {
+    for (size_t g = first; g < last; g++) {
+        check_guess_batch(job->words[g], job->words, job->answer_count, job->cells + g * job->answer_count);
+    }
+}
+
+static void *build_worker(void *arg) {
+    MatrixBuildJob *job = arg;
+
+    // Each worker claims the next block of rows until none are left. Rows
+    // are disjoint, so the result does not depend on the schedule.
+    for (;;) {
+        size_t first = atomic_fetch_add(&job->next_row, MATRIX_BLOCK_ROWS);
+        if (first >= job->count) {
+            break;
+        }
+        size_t last = first + MATRIX_BLOCK_ROWS;
+        if (last > job->count) {
+            last = job->count;
+        }
+        build_rows(job, first, last);
+    }
+
+    return NULL;
+}
+
+int default_thread_count(void) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 ? (int)online : 1;
+}
+
+void matrix_build(const uint32_t *words, size_t count, size_t answer_count, int threads, PatternMatrix *matrix) {
+    uint8_t *cells = malloc(count * answer_count);
+    if (cells == NULL && count > 0) {
+        perror("Failed to allocate pattern matrix");
+        exit(EXIT_FAILURE);
+    }
+
+    if (threads <= 0) {
+        threads = default_thread_count();
+    }
+    if ((size_t)threads > count / MATRIX_BLOCK_ROWS) {
+        threads = (int)(count / MATRIX_BLOCK_ROWS) + 1;
+    }
+
+    MatrixBuildJob job = {words, count, answer_count, cells, 0};
+    pthread_t workers[MAX_THREADS];
+    int started = 0;
+
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+    // The calling thread is the first worker
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[started], NULL, build_worker, &job) != 0) {
+            break;
+        }
+        started++;
+    }
+    build_worker(&job);
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+
+    memset(matrix, 0, sizeof(*matrix));
+    matrix->cells = cells;
+    matrix->owned = cells;
+    matrix->count = answer_count;
+    matrix->guess_count = count;
+    matrix->list_hash = hash_word_sets(words, count, answer_count);
+}
+
+bool matrix_load(const char *path, const uint32_t *words, size_t count, size_t answer_count, PatternMatrix *matrix) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    size_t expected = sizeof(MatrixHeader) + count * answer_count;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != expected) {
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, expected, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    const MatrixHeader *header = map;
+    uint64_t list_hash = hash_word_sets(words, count, answer_count);
+    if (memcmp(header->magic, MATRIX_MAGIC, 4) != 0 ||
+        header->version != MATRIX_VERSION ||
+        header->word_length != WORD_LENGTH ||
+        header->count != count ||
+        header->answer_count != answer_count ||
+        header->list_hash != list_hash) {
+        munmap(map, expected);
+        return false;
+    }
+
+    memset(matrix, 0, sizeof(*matrix));
+    matrix->cells = (const uint8_t *)map + sizeof(MatrixHeader);
+    matrix->count = answer_count;
+    matrix->guess_count = count;
+    matrix->list_hash = list_hash;
+    matrix->map = map;
+    matrix->map_size = expected;
+    return true;
+}
+
+bool matrix_save(const char *path, const PatternMatrix *matrix) {
+    // Write to a temporary name and rename it into place so a concurrent
+    // reader never maps a half-written table
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", path, (long)getpid());
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (file == NULL) {
+        perror("Failed to create pattern cache");
+        return false;
+    }
+
+    MatrixHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MATRIX_MAGIC, 4);
+    header.version = MATRIX_VERSION;
+    header.word_length = WORD_LENGTH;
+    header.count = (uint32_t)matrix->guess_count;
+    header.list_hash = matrix->list_hash;
+    header.answer_count = (uint32_t)matrix->count;
+
+    size_t cells = matrix->guess_count * matrix->count;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(matrix->cells, 1, cells, file) == cells;
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok || rename(tmp_path, path) != 0) {
+        perror("Failed to write pattern cache");
+        remove(tmp_path);
+        return false;
+    }
+
+    return true;
+}
+
+void matrix_open(const char *path, const uint32_t *words, size_t count, size_t answer_count, PatternMatrix *matrix) {
+    if (path != NULL && matrix_load(path, words, count, answer_count, matrix)) {
+        return;
+    }
+
+    matrix_build(words, count, answer_count, 0, matrix);
+    if (path != NULL) {
+        matrix_save(path, matrix);
+    }
+}
+
+void matrix_free(PatternMatrix *matrix) {
+    if (matrix->map != NULL) {
+        munmap(matrix->map, matrix->map_size);
+    }
+    free(matrix->owned);
+    memset(matrix, 0, sizeof(*matrix));
+}
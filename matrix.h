@@ -0,0 +1,57 @@
+// matrix.h
+
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MATRIX_MAGIC "WPMX"
+#define MATRIX_VERSION 2
+
+// On-disk header; the count * answer_count pattern bytes follow
+// immediately, row-major by guess.
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t word_length;
+    uint32_t count;         // guesses (rows)
+    uint64_t list_hash;
+    uint32_t answer_count;  // secrets (columns)
+    uint32_t reserved;
+} MatrixHeader;
+
+// Guess x secret feedback table over a list whose first answer_count
+// words are the possible secrets (see wordlist.h). cells[g * count + s] is
+// score_packed(words[s], words[g]) for every guess g < guess_count and
+// secret s < count, so a row is as wide as the answer list.
+typedef struct {
+    const uint8_t *cells;
+    size_t count;           // secrets per row
+    size_t guess_count;     // rows
+    uint64_t list_hash;
+    void *map;          // mmapped cache file, or NULL
+    size_t map_size;
+    uint8_t *owned;     // heap table when built in this process, or NULL
+} PatternMatrix;
+
+// Function declarations
+uint64_t hash_word_list(const uint32_t *words, size_t count);
+uint64_t hash_word_sets(const uint32_t *words, size_t count, size_t answer_count);
+int default_thread_count(void);
+void matrix_build(const uint32_t *words, size_t count, size_t answer_count, int threads, PatternMatrix *matrix);
+bool matrix_load(const char *path, const uint32_t *words, size_t count, size_t answer_count, PatternMatrix *matrix);
+bool matrix_save(const char *path, const PatternMatrix *matrix);
+void matrix_open(const char *path, const uint32_t *words, size_t count, size_t answer_count, PatternMatrix *matrix);
+void matrix_free(PatternMatrix *matrix);
+
+static inline const uint8_t *matrix_row(const PatternMatrix *matrix, size_t guess) {
+    return matrix->cells + guess * matrix->count;
+}
+
+static inline uint8_t matrix_lookup(const PatternMatrix *matrix, size_t guess, size_t secret) {
+    return matrix->cells[guess * matrix->count + secret];
+}
+
+#endif
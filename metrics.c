@@ -0,0 +1,159 @@
+/*
+ * File: metrics.c
+ * Description: Lock-free runtime counters and latency histograms.
+ *
+ *   Every thread that records a metric gets its own cache-aligned shard on
+ *   first use, pushed onto a global list with one compare-and-swap; after
+ *   that recording is a couple of relaxed loads and stores on memory no
+ *   other thread writes. metrics_format walks the list and sums the shards
+ *   into the Prometheus text exposition format, so a scrape never stops
+ *   the threads it measures and each value is at worst a few increments
+ *   stale.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "metrics.h"
+
+#define METRICS_FORMAT_SIZE 16384
+
+_Thread_local MetricsShard *metrics_local_shard;
+
+static _Atomic(MetricsShard *) shards;
+
+static const struct {
+    const char *name;
+    const char *help;
+} counter_info[METRIC_COUNT] = {
+    [METRIC_GUESSES_SCORED] = {"wordle_guesses_scored_total", "Guesses scored against a secret."},
+    [METRIC_VALIDATION_HITS] = {"wordle_validation_hits_total", "Guesses found in the word list."},
+    [METRIC_VALIDATION_MISSES] = {"wordle_validation_misses_total", "Guesses rejected as not in the word list."},
+    [METRIC_SECRETS_CHOSEN] = {"wordle_secrets_chosen_total", "Secret words drawn for new games."},
+    [METRIC_GAMES_WON] = {"wordle_games_won_total", "Games solved within the attempt limit."},
+    [METRIC_GAMES_LOST] = {"wordle_games_lost_total", "Games that ran out of attempts."},
+    [METRIC_SESSIONS_OPENED] = {"wordle_sessions_opened_total", "Server connections accepted."},
+    [METRIC_SESSIONS_CLOSED] = {"wordle_sessions_closed_total", "Server connections closed."},
+    [METRIC_DICTIONARY_RELOADS] = {"wordle_dictionary_reloads_total", "Dictionary reloads triggered by SIGHUP."},
+    [METRIC_GAMES_LOGGED] = {"wordle_games_logged_total", "Completed games written to the game log."},
+};
+
+static const struct {
+    const char *name;
+    const char *help;
+} histogram_info[HISTOGRAM_COUNT] = {
+    [HISTOGRAM_CHECK_GUESS] = {"wordle_check_guess_seconds", "Time to score one guess (sampled)."},
+    [HISTOGRAM_SOLVER_NEXT_GUESS] = {"wordle_solver_next_guess_seconds", "Time for the solver to pick a guess."},
+    [HISTOGRAM_DICT_LOAD] = {"wordle_dict_load_seconds", "Time to load a word list."},
+};
+
+MetricsShard *metrics_register_thread(void) {
+    MetricsShard *shard = aligned_alloc(64, (sizeof(MetricsShard) + 63) & ~(size_t)63);
+    if (shard == NULL) {
+        perror("Failed to allocate metrics");
+        exit(EXIT_FAILURE);
+    }
+    memset(shard, 0, sizeof(*shard));
+
+    shard->next = atomic_load_explicit(&shards, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&shards, &shard->next, shard,
+                                                  memory_order_release, memory_order_relaxed)) {
+    }
+
+    metrics_local_shard = shard;
+    return shard;
+}
+
+typedef struct {
+    char *out;
+    size_t capacity;
+    size_t length;              // may exceed capacity; the total is returned
+} MetricsWriter;
+
+__attribute__((format(printf, 2, 3)))
+static void emit(MetricsWriter *writer, const char *format, ...) {
+    size_t room = writer->length < writer->capacity ? writer->capacity - writer->length : 0;
+    va_list args;
+
+    va_start(args, format);
+    int n = vsnprintf(room > 0 ? writer->out + writer->length : NULL, room, format, args);
+    va_end(args);
+    if (n > 0) {
+        writer->length += (size_t)n;
+    }
+}
+
+static uint64_t load(const _Atomic uint64_t *cell) {
+    return atomic_load_explicit(cell, memory_order_relaxed);
+}
+
+// Writes the exposition text, NUL-terminated when it fits; returns its
+// full length like snprintf
+size_t metrics_format(char *out, size_t capacity) {
+    MetricsWriter writer = {out, capacity, 0};
+    uint64_t counters[METRIC_COUNT] = {0};
+    uint64_t buckets[HISTOGRAM_COUNT][METRICS_BUCKETS] = {{0}};
+    uint64_t sums[HISTOGRAM_COUNT] = {0};
+
+    for (MetricsShard *shard = atomic_load_explicit(&shards, memory_order_acquire); shard != NULL;
+         shard = shard->next) {
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            counters[m] += load(&shard->counters[m]);
+        }
+        for (int h = 0; h < HISTOGRAM_COUNT; h++) {
+            for (int b = 0; b < METRICS_BUCKETS; b++) {
+                buckets[h][b] += load(&shard->buckets[h][b]);
+            }
+            sums[h] += load(&shard->sum_ns[h]);
+        }
+    }
+
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        emit(&writer, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", counter_info[m].name, counter_info[m].help,
+             counter_info[m].name, counter_info[m].name, (unsigned long long)counters[m]);
+    }
+
+    // Shards are read one after another, so clamp a momentary close-before-open
+    uint64_t opened = counters[METRIC_SESSIONS_OPENED];
+    uint64_t closed = counters[METRIC_SESSIONS_CLOSED];
+    emit(&writer, "# HELP wordle_sessions_active Server connections currently open.\n"
+                  "# TYPE wordle_sessions_active gauge\nwordle_sessions_active %llu\n",
+         (unsigned long long)(opened > closed ? opened - closed : 0));
+
+    for (int h = 0; h < HISTOGRAM_COUNT; h++) {
+        const char *name = histogram_info[h].name;
+        uint64_t cumulative = 0;
+
+        emit(&writer, "# HELP %s %s\n# TYPE %s histogram\n", name, histogram_info[h].help, name);
+        for (int b = 0; b < METRICS_BUCKETS - 1; b++) {
+            cumulative += buckets[h][b];
+            emit(&writer, "%s_bucket{le=\"%.9g\"} %llu\n", name, (double)(1ull << b) / 1e9,
+                 (unsigned long long)cumulative);
+        }
+        cumulative += buckets[h][METRICS_BUCKETS - 1];
+        emit(&writer, "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %.9f\n%s_count %llu\n", name,
+             (unsigned long long)cumulative, name, sums[h] / 1e9, name, (unsigned long long)cumulative);
+    }
+
+    return writer.length;
+}
+
+// Heap copy for callers that hand the text to a socket later
+char *metrics_format_alloc(size_t *length) {
+    size_t capacity = METRICS_FORMAT_SIZE;
+
+    for (;;) {
+        char *out = malloc(capacity);
+        if (out == NULL) {
+            return NULL;
+        }
+        size_t needed = metrics_format(out, capacity);
+        if (needed < capacity) {
+            *length = needed;
+            return out;
+        }
+        free(out);
+        capacity = needed + 1;
+    }
+}
@@ -0,0 +1,97 @@
+// metrics.h
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "timing.h"
+
+// Latency buckets are powers of two in nanoseconds: bucket k counts
+// observations in (2^(k-1), 2^k] ns, so its cumulative count is exactly
+// Prometheus's le="2^k"; the last one holds everything above about half
+// a second
+#define METRICS_BUCKETS 31
+
+// check_guess is timed on one call in 2^METRICS_SAMPLE_SHIFT per thread;
+// the clock read would otherwise cost as much as the scoring itself
+#define METRICS_SAMPLE_SHIFT 6
+
+typedef enum {
+    METRIC_GUESSES_SCORED,
+    METRIC_VALIDATION_HITS,
+    METRIC_VALIDATION_MISSES,
+    METRIC_SECRETS_CHOSEN,
+    METRIC_GAMES_WON,
+    METRIC_GAMES_LOST,
+    METRIC_SESSIONS_OPENED,
+    METRIC_SESSIONS_CLOSED,
+    METRIC_DICTIONARY_RELOADS,
+    METRIC_GAMES_LOGGED,
+    METRIC_COUNT
+} Metric;
+
+typedef enum {
+    HISTOGRAM_CHECK_GUESS,
+    HISTOGRAM_SOLVER_NEXT_GUESS,
+    HISTOGRAM_DICT_LOAD,
+    HISTOGRAM_COUNT
+} Histogram;
+
+// One per thread, written only by its owner with plain relaxed stores and
+// read by metrics_format from any thread; shards outlive their threads so
+// totals never go backwards
+typedef struct MetricsShard {
+    _Atomic uint64_t counters[METRIC_COUNT];
+    _Atomic uint64_t buckets[HISTOGRAM_COUNT][METRICS_BUCKETS];
+    _Atomic uint64_t sum_ns[HISTOGRAM_COUNT];
+    uint64_t sample_tick;
+    struct MetricsShard *next;
+} MetricsShard;
+
+extern _Thread_local MetricsShard *metrics_local_shard;
+
+// Function declarations
+MetricsShard *metrics_register_thread(void);
+size_t metrics_format(char *out, size_t capacity);
+char *metrics_format_alloc(size_t *length);
+
+static inline MetricsShard *metrics_shard(void) {
+    MetricsShard *shard = metrics_local_shard;
+    return shard != NULL ? shard : metrics_register_thread();
+}
+
+// Single writer per shard, so a load and a store replace a locked add
+static inline void metrics_bump(_Atomic uint64_t *cell, uint64_t n) {
+    atomic_store_explicit(cell, atomic_load_explicit(cell, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+static inline void metrics_add(Metric metric, uint64_t n) {
+    metrics_bump(&metrics_shard()->counters[metric], n);
+}
+
+static inline void metrics_observe(Histogram histogram, uint64_t ns) {
+    MetricsShard *shard = metrics_shard();
+    int bucket = ns <= 1 ? 0 : 64 - __builtin_clzll(ns - 1);
+
+    if (bucket >= METRICS_BUCKETS) {
+        bucket = METRICS_BUCKETS - 1;
+    }
+    metrics_bump(&shard->buckets[histogram][bucket], 1);
+    metrics_bump(&shard->sum_ns[histogram], ns);
+}
+
+// Nonzero start time on the calls that should be timed, zero otherwise
+static inline uint64_t metrics_sample_start(void) {
+    MetricsShard *shard = metrics_shard();
+    return (shard->sample_tick++ & ((1u << METRICS_SAMPLE_SHIFT) - 1)) == 0 ? monotonic_ns() : 0;
+}
+
+static inline void metrics_sample_end(Histogram histogram, uint64_t start_ns) {
+    if (start_ns != 0) {
+        metrics_observe(histogram, monotonic_ns() - start_ns);
+    }
+}
+
+#endif
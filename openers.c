@@ -0,0 +1,297 @@
+/*
+ * File: openers.c
+ * Description: Exhaustive first-guess ranking.
+ *
+ *   Every word in the list is scored as an opener against every answer:
+ *   its 243-bucket pattern histogram gives the expected information
+ *   (entropy) and the expected number of candidates left. Rows come from
+ *   the pattern matrix cache when it matches the list, otherwise each
+ *   worker scores its rows with check_guess_batch, so huge dictionaries
+ *   never need the guesses x answers table in memory.
+ *
+ *   Workers claim blocks of guesses from a shared counter, so slow and
+ *   fast cores finish together. Finished blocks are flagged, and with a
+ *   checkpoint file the scores so far are written out every few seconds
+ *   (temporary file plus rename); a rerun with the same file skips
+ *   everything already done.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "wordle.h"
+#include "score.h"
+#include "matrix.h"
+#include "openers.h"
+#include "timing.h"
+
+typedef struct {
+    const WordList *list;
+    const PatternMatrix *matrix;    // NULL to score rows on the fly
+    OpenerScore *scores;
+    atomic_uchar *done;             // per block
+    size_t blocks;
+    atomic_size_t next_block;
+    const char *checkpoint;
+    uint64_t list_hash;
+    pthread_mutex_t checkpoint_lock;
+    uint64_t last_checkpoint_ns;    // guarded by checkpoint_lock
+} RankJob;
+
+static void score_opener(const uint8_t *row, size_t count, OpenerScore *score) {
+    uint32_t histogram[PATTERN_COUNT];
+    double sum_log = 0.0;
+    double sum_square = 0.0;
+
+    memset(histogram, 0, sizeof(histogram));
+    for (size_t s = 0; s < count; s++) {
+        histogram[row[s]]++;
+    }
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        double c = histogram[p];
+        if (c > 0) {
+            sum_log += c * log2(c);
+            sum_square += c * c;
+        }
+    }
+
+    score->entropy = log2((double)count) - sum_log / count;
+    score->expected_remaining = sum_square / count;
+}
+
+static bool save_checkpoint(RankJob *job) {
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", job->checkpoint, (long)getpid());
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (file == NULL) {
+        perror("Failed to create checkpoint");
+        return false;
+    }
+
+    OpenersHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OPENERS_MAGIC, 4);
+    header.version = OPENERS_VERSION;
+    header.word_length = WORD_LENGTH;
+    header.count = (uint32_t)job->list->count;
+    header.list_hash = job->list_hash;
+
+    // Only blocks flagged done are trusted on resume, so a block still
+    // being written is harmless; the acquire pairs with the worker's release
+    uint8_t *done = malloc(job->blocks);
+    if (done == NULL) {
+        fclose(file);
+        remove(tmp_path);
+        return false;
+    }
+    for (size_t b = 0; b < job->blocks; b++) {
+        done[b] = atomic_load_explicit(&job->done[b], memory_order_acquire);
+    }
+
+    size_t count = job->list->count;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(job->scores, sizeof(OpenerScore), count, file) == count &&
+              fwrite(done, 1, job->blocks, file) == job->blocks;
+    ok = fclose(file) == 0 && ok;
+    free(done);
+
+    if (!ok || rename(tmp_path, job->checkpoint) != 0) {
+        perror("Failed to write checkpoint");
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+// Returns the number of blocks restored
+static size_t load_checkpoint(RankJob *job) {
+    FILE *file = fopen(job->checkpoint, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    OpenersHeader header;
+    size_t count = job->list->count;
+    size_t restored = 0;
+    uint8_t *done = malloc(job->blocks);
+    OpenerScore *scores = malloc(count * sizeof(OpenerScore));
+
+    if (done != NULL && scores != NULL &&
+        fread(&header, sizeof(header), 1, file) == 1 &&
+        memcmp(header.magic, OPENERS_MAGIC, 4) == 0 &&
+        header.version == OPENERS_VERSION &&
+        header.word_length == WORD_LENGTH &&
+        header.count == count &&
+        header.list_hash == job->list_hash &&
+        fread(scores, sizeof(OpenerScore), count, file) == count &&
+        fread(done, 1, job->blocks, file) == job->blocks) {
+        for (size_t b = 0; b < job->blocks; b++) {
+            if (done[b]) {
+                size_t first = b * OPENERS_BLOCK_ROWS;
+                size_t last = first + OPENERS_BLOCK_ROWS < count ? first + OPENERS_BLOCK_ROWS : count;
+                memcpy(job->scores + first, scores + first, (last - first) * sizeof(OpenerScore));
+                atomic_store(&job->done[b], 1);
+                restored++;
+            }
+        }
+    } else {
+        fprintf(stderr, "Ignoring checkpoint %s: it belongs to another word list.\n", job->checkpoint);
+    }
+
+    free(done);
+    free(scores);
+    fclose(file);
+    return restored;
+}
+
+static void *rank_worker(void *arg) {
+    RankJob *job = arg;
+    size_t count = job->list->count;
+    size_t answers = job->list->answer_count;
+    uint8_t *row = job->matrix == NULL ? malloc(answers) : NULL;
+    if (job->matrix == NULL && row == NULL) {
+        perror("Failed to allocate opener ranking");
+        exit(EXIT_FAILURE);
+    }
+
+    for (;;) {
+        size_t b = atomic_fetch_add(&job->next_block, 1);
+        if (b >= job->blocks) {
+            break;
+        }
+        if (atomic_load_explicit(&job->done[b], memory_order_relaxed)) {
+            continue;
+        }
+
+        size_t first = b * OPENERS_BLOCK_ROWS;
+        size_t last = first + OPENERS_BLOCK_ROWS < count ? first + OPENERS_BLOCK_ROWS : count;
+        for (size_t g = first; g < last; g++) {
+            const uint8_t *patterns = row;
+            if (job->matrix != NULL) {
+                patterns = matrix_row(job->matrix, g);
+            } else {
+                check_guess_batch(job->list->packed[g], job->list->packed, answers, row);
+            }
+            score_opener(patterns, answers, &job->scores[g]);
+        }
+        atomic_store_explicit(&job->done[b], 1, memory_order_release);
+
+        // Whoever finishes a block once the interval has passed writes the
+        // checkpoint; the others keep working rather than wait for it
+        if (job->checkpoint != NULL && pthread_mutex_trylock(&job->checkpoint_lock) == 0) {
+            if (elapsed_seconds(job->last_checkpoint_ns) >= OPENERS_CHECKPOINT_SECONDS) {
+                save_checkpoint(job);
+                job->last_checkpoint_ns = monotonic_ns();
+            }
+            pthread_mutex_unlock(&job->checkpoint_lock);
+        }
+    }
+
+    free(row);
+    return NULL;
+}
+
+typedef struct {
+    double key;                 // smaller ranks first
+    uint32_t word;
+} RankedOpener;
+
+static int compare_openers(const void *a, const void *b) {
+    const RankedOpener *x = a;
+    const RankedOpener *y = b;
+    if (x->key != y->key) {
+        return x->key < y->key ? -1 : 1;
+    }
+    // Equal scores keep list order
+    return (x->word > y->word) - (x->word < y->word);
+}
+
+int rank_openers(const WordList *list, const RankOptions *options) {
+    size_t count = list->count;
+    int threads = options->threads > 0 ? options->threads : default_thread_count();
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    RankJob job;
+    memset(&job, 0, sizeof(job));
+    job.list = list;
+    job.blocks = (count + OPENERS_BLOCK_ROWS - 1) / OPENERS_BLOCK_ROWS;
+    job.checkpoint = options->checkpoint;
+    job.list_hash = hash_word_sets(list->packed, count, list->answer_count);
+    job.scores = calloc(count, sizeof(OpenerScore));
+    job.done = calloc(job.blocks, sizeof(atomic_uchar));
+    RankedOpener *order = malloc(count * sizeof(RankedOpener));
+    if (job.scores == NULL || job.done == NULL || order == NULL) {
+        perror("Failed to allocate opener ranking");
+        exit(EXIT_FAILURE);
+    }
+    atomic_init(&job.next_block, 0);
+    pthread_mutex_init(&job.checkpoint_lock, NULL);
+
+    // Use the cached matrix only if it is already on disk; building it
+    // here would cost as much as the ranking itself
+    PatternMatrix matrix;
+    bool have_matrix = matrix_load(PATTERN_CACHE_FILE, list->packed, count, list->answer_count, &matrix);
+    job.matrix = have_matrix ? &matrix : NULL;
+
+    size_t restored = job.checkpoint != NULL ? load_checkpoint(&job) : 0;
+    if (restored > 0) {
+        printf("Resuming from %s: %zu of %zu blocks already scored.\n", job.checkpoint, restored, job.blocks);
+    }
+
+    uint64_t start = monotonic_ns();
+    job.last_checkpoint_ns = start;
+    pthread_t handles[MAX_THREADS];
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[started], NULL, rank_worker, &job) != 0) {
+            break;
+        }
+        started++;
+    }
+    rank_worker(&job);
+    for (int t = 0; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+    double seconds = elapsed_seconds(start);
+
+    bool saved = job.checkpoint == NULL || save_checkpoint(&job);
+
+    double pairs = (double)count * list->answer_count * (double)(job.blocks - restored) / (double)job.blocks;
+    printf("Ranked %zu openers on %d thread%s in %.3f s (%s, %.1f M pairs/s).\n",
+           count, threads, threads == 1 ? "" : "s", seconds,
+           have_matrix ? "pattern matrix" : "scored on the fly", seconds > 0 ? pairs / seconds / 1e6 : 0.0);
+
+    for (size_t i = 0; i < count; i++) {
+        order[i].key = options->rank_by == RANK_BY_ENTROPY ? -job.scores[i].entropy
+                                                           : job.scores[i].expected_remaining;
+        order[i].word = (uint32_t)i;
+    }
+    qsort(order, count, sizeof(RankedOpener), compare_openers);
+
+    size_t top = options->top > 0 ? options->top : OPENERS_DEFAULT_TOP;
+    if (top > count) {
+        top = count;
+    }
+    printf("Rank  Word   Entropy  Expected left\n");
+    for (size_t i = 0; i < top; i++) {
+        const OpenerScore *score = &job.scores[order[i].word];
+        printf("%4zu  %.*s  %7.4f  %13.2f\n", i + 1, WORD_LENGTH, wordlist_word(list, order[i].word),
+               score->entropy, score->expected_remaining);
+    }
+
+    if (have_matrix) {
+        matrix_free(&matrix);
+    }
+    pthread_mutex_destroy(&job.checkpoint_lock);
+    free(job.scores);
+    free((void *)job.done);
+    free(order);
+    return saved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
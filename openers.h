@@ -0,0 +1,47 @@
+// openers.h
+
+#ifndef OPENERS_H
+#define OPENERS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordlist.h"
+
+#define OPENERS_MAGIC "WORK"
+#define OPENERS_VERSION 1
+#define OPENERS_DEFAULT_TOP 10
+#define OPENERS_BLOCK_ROWS 16
+#define OPENERS_CHECKPOINT_SECONDS 10.0
+
+typedef enum {
+    RANK_BY_ENTROPY,        // most information first
+    RANK_BY_REMAINING       // fewest expected remaining candidates first
+} RankBy;
+
+typedef struct {
+    size_t top;                 // rows to print, 0 for OPENERS_DEFAULT_TOP
+    int threads;                // worker threads, 0 for all online cores
+    RankBy rank_by;
+    const char *checkpoint;     // progress file to resume from, or NULL
+} RankOptions;
+
+// Checkpoint file: this header, then one OpenerScore per word, then one
+// byte per OPENERS_BLOCK_ROWS block that is nonzero once the block is done
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t word_length;
+    uint32_t count;
+    uint64_t list_hash;
+} OpenersHeader;
+
+typedef struct {
+    double entropy;             // bits of information from the feedback
+    double expected_remaining;  // sum of bucket^2 / count
+} OpenerScore;
+
+// Function declarations
+int rank_openers(const WordList *list, const RankOptions *options);
+
+#endif
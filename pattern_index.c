@@ -0,0 +1,126 @@
+/*
+ * File: pattern_index.c
+ * Description: Per-guess, per-pattern candidate bitsets.
+ *
+ *   For a guess g, the index holds one bitset per feedback pattern marking
+ *   the secrets that produce it, so narrowing a candidate set after a
+ *   feedback is one word-wise AND of about N/64 words. A guess's 243
+ *   bitsets are built from its matrix row the first time it is looked up
+ *   and kept in a fixed number of slots with least-recently-used eviction,
+ *   which bounds memory regardless of dictionary size.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "score.h"
+#include "pattern_index.h"
+
+static size_t entry_words(const PatternIndex *index) {
+    return (size_t)PATTERN_COUNT * index->set_words;
+}
+
+size_t pattern_index_capacity_for(const PatternMatrix *matrix, size_t budget_bytes) {
+    size_t per_guess = (size_t)PATTERN_COUNT * ((matrix->count + 63) / 64) * sizeof(uint64_t);
+    size_t capacity = per_guess > 0 ? budget_bytes / per_guess : 0;
+    return capacity > 0 ? capacity : 1;
+}
+
+void pattern_index_init(PatternIndex *index, const PatternMatrix *matrix, size_t capacity) {
+    memset(index, 0, sizeof(*index));
+    index->matrix = matrix;
+    index->set_words = (matrix->count + 63) / 64;
+    index->capacity = capacity > 0 ? capacity : 1;
+    index->head = PATTERN_INDEX_NONE;
+    index->tail = PATTERN_INDEX_NONE;
+
+    index->entries = malloc(index->capacity * sizeof(PatternIndexEntry));
+    index->slot_of = malloc(matrix->guess_count * sizeof(uint32_t));
+    index->storage = malloc(index->capacity * entry_words(index) * sizeof(uint64_t));
+    if (index->entries == NULL || index->slot_of == NULL || index->storage == NULL) {
+        perror("Failed to allocate pattern index");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t g = 0; g < matrix->guess_count; g++) {
+        index->slot_of[g] = PATTERN_INDEX_NONE;
+    }
+    for (size_t e = 0; e < index->capacity; e++) {
+        index->entries[e].guess = PATTERN_INDEX_NONE;
+        index->entries[e].sets = index->storage + e * entry_words(index);
+    }
+}
+
+void pattern_index_free(PatternIndex *index) {
+    free(index->entries);
+    free(index->slot_of);
+    free(index->storage);
+    memset(index, 0, sizeof(*index));
+}
+
+static void unlink_entry(PatternIndex *index, uint32_t slot) {
+    PatternIndexEntry *entry = &index->entries[slot];
+
+    if (entry->prev != PATTERN_INDEX_NONE) {
+        index->entries[entry->prev].next = entry->next;
+    } else {
+        index->head = entry->next;
+    }
+    if (entry->next != PATTERN_INDEX_NONE) {
+        index->entries[entry->next].prev = entry->prev;
+    } else {
+        index->tail = entry->prev;
+    }
+}
+
+static void push_front(PatternIndex *index, uint32_t slot) {
+    PatternIndexEntry *entry = &index->entries[slot];
+
+    entry->prev = PATTERN_INDEX_NONE;
+    entry->next = index->head;
+    if (index->head != PATTERN_INDEX_NONE) {
+        index->entries[index->head].prev = slot;
+    }
+    index->head = slot;
+    if (index->tail == PATTERN_INDEX_NONE) {
+        index->tail = slot;
+    }
+}
+
+static void materialize(PatternIndex *index, PatternIndexEntry *entry, size_t guess) {
+    const uint8_t *row = matrix_row(index->matrix, guess);
+    size_t set_words = index->set_words;
+
+    memset(entry->sets, 0, entry_words(index) * sizeof(uint64_t));
+    for (size_t s = 0; s < index->matrix->count; s++) {
+        entry->sets[row[s] * set_words + s / 64] |= UINT64_C(1) << (s % 64);
+    }
+    entry->guess = (uint32_t)guess;
+}
+
+const uint64_t *pattern_index_lookup(PatternIndex *index, size_t guess, uint8_t pattern) {
+    uint32_t slot = index->slot_of[guess];
+
+    if (slot != PATTERN_INDEX_NONE) {
+        index->hits++;
+        if (slot != index->head) {
+            unlink_entry(index, slot);
+            push_front(index, slot);
+        }
+    } else {
+        index->misses++;
+        if (index->used < index->capacity) {
+            slot = (uint32_t)index->used++;
+        } else {
+            // Recycle the least recently used guess
+            slot = index->tail;
+            unlink_entry(index, slot);
+            index->slot_of[index->entries[slot].guess] = PATTERN_INDEX_NONE;
+        }
+        materialize(index, &index->entries[slot], guess);
+        index->slot_of[guess] = slot;
+        push_front(index, slot);
+    }
+
+    return index->entries[slot].sets + (size_t)pattern * index->set_words;
+}
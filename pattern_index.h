@@ -0,0 +1,43 @@
+// pattern_index.h
+
+#ifndef PATTERN_INDEX_H
+#define PATTERN_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+
+#define PATTERN_INDEX_NONE UINT32_MAX
+
+// One materialised guess: PATTERN_COUNT bitsets of set_words each, where
+// bit s of set p is on when guessing this word against secret s gives p
+typedef struct {
+    uint32_t guess;
+    uint32_t prev;      // towards the most recently used entry
+    uint32_t next;      // towards the least recently used entry
+    uint64_t *sets;
+} PatternIndexEntry;
+
+// LRU cache of per-guess pattern bitsets built lazily from the matrix.
+// Lookups reorder the cache, so each thread needs its own index.
+typedef struct {
+    const PatternMatrix *matrix;
+    size_t set_words;
+    size_t capacity;
+    PatternIndexEntry *entries;
+    uint32_t *slot_of;  // guess -> entry, or PATTERN_INDEX_NONE
+    uint32_t head;      // most recently used
+    uint32_t tail;      // least recently used, evicted first
+    size_t used;
+    uint64_t *storage;
+    uint64_t hits;
+    uint64_t misses;
+} PatternIndex;
+
+// Function declarations
+size_t pattern_index_capacity_for(const PatternMatrix *matrix, size_t budget_bytes);
+void pattern_index_init(PatternIndex *index, const PatternMatrix *matrix, size_t capacity);
+void pattern_index_free(PatternIndex *index);
+const uint64_t *pattern_index_lookup(PatternIndex *index, size_t guess, uint8_t pattern);
+
+#endif
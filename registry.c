@@ -0,0 +1,289 @@
+/*
+ * File: registry.c
+ * Description: Named dictionaries shared by every game in the process, and
+ *   swapped in place when their files change.
+ *
+ *   A dictionary pairs an answer list with an optional allowed-guess list
+ *   (a large list of valid words, a small one of possible secrets). It is
+ *   loaded once with wordlist_load_split and never written again, so any
+ *   number of sessions on any thread play from the same copy. The
+ *   validation bitmap is mapped read-only straight out of a binary
+ *   dictionary packed --with-index, where the guess list allows it (see
+ *   word_index_open_split), so every process serving that file shares the
+ *   same page-cache pages; only the decoded word list, a few bytes per
+ *   word, is private.
+ *
+ *   Dictionaries are registered under names: "--dict NAME=ANSWERS[:GUESSES]"
+ *   on the command line, "NEW NAME" in the server protocol. Registering the
+ *   same files under a second name reuses the loaded dictionary.
+ *
+ *   registry_reload rereads every file into fresh snapshots and swaps the
+ *   entry pointers. Reclamation is quiescent-state based: readers (the
+ *   server's event loops) go offline before blocking in epoll_wait, and a
+ *   replaced snapshot keeps the registry's reference until every reader
+ *   has been offline or observed the new epoch. After that nobody can be
+ *   between loading the old pointer and acquiring it, so the reference is
+ *   dropped, and the snapshot is freed when its last game releases it.
+ *   Scoring a guess touches none of this: a game keeps plain pointers into
+ *   the snapshot it acquired.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "registry.h"
+
+static char *copy_path(const char *path, bool *ok) {
+    if (path == NULL) {
+        return NULL;
+    }
+    char *copy = strdup(path);
+    *ok = *ok && copy != NULL;
+    return copy;
+}
+
+bool dictionary_load(const char *answers_file, const char *guesses_file, const char *strategy_file,
+                     Dictionary *dict) {
+    memset(dict, 0, sizeof(*dict));
+
+    bool loaded = guesses_file != NULL ? wordlist_load_split(answers_file, guesses_file, &dict->list)
+                                       : wordlist_load(answers_file, &dict->list);
+    if (!loaded) {
+        return false;
+    }
+    if (guesses_file != NULL) {
+        word_index_open_split(guesses_file, &dict->list, &dict->valid);
+    } else {
+        word_index_open(answers_file, &dict->list, &dict->valid);
+    }
+    // A tree built for another list is reported and left out
+    dict->have_strategy = strategy_file != NULL && strategy_load(strategy_file, &dict->list, &dict->strategy);
+
+    bool ok = true;
+    dict->answers_file = copy_path(answers_file, &ok);
+    dict->guesses_file = copy_path(guesses_file, &ok);
+    dict->strategy_file = copy_path(strategy_file, &ok);
+    if (!ok) {
+        perror("Failed to allocate dictionary");
+        dictionary_free(dict);
+        return false;
+    }
+    atomic_init(&dict->refs, 1);
+    return true;
+}
+
+void dictionary_free(Dictionary *dict) {
+    if (dict->have_strategy) {
+        strategy_free(&dict->strategy);
+    }
+    word_index_free(&dict->valid);
+    wordlist_free(&dict->list);
+    free(dict->answers_file);
+    free(dict->guesses_file);
+    free(dict->strategy_file);
+    memset(dict, 0, sizeof(*dict));
+}
+
+// The reference count is the only field that changes after loading
+void dictionary_acquire(const Dictionary *dict) {
+    atomic_fetch_add_explicit(&((Dictionary *)dict)->refs, 1, memory_order_relaxed);
+}
+
+void dictionary_release(const Dictionary *dict) {
+    Dictionary *owned = (Dictionary *)dict;
+    if (atomic_fetch_sub_explicit(&owned->refs, 1, memory_order_acq_rel) == 1) {
+        dictionary_free(owned);
+        free(owned);
+    }
+}
+
+void registry_init(DictRegistry *registry) {
+    memset(registry, 0, sizeof(*registry));
+    pthread_mutex_init(&registry->lock, NULL);
+}
+
+static bool same_file(const char *a, const char *b) {
+    return (a == NULL && b == NULL) || (a != NULL && b != NULL && strcmp(a, b) == 0);
+}
+
+static Dictionary *add_locked(DictRegistry *registry, const char *name, const char *answers_file,
+                              const char *guesses_file, const char *strategy_file) {
+    size_t count = atomic_load_explicit(&registry->count, memory_order_relaxed);
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(registry->entries[i].name, name) == 0) {
+            fprintf(stderr, "Dictionary '%s' is already registered.\n", name);
+            return NULL;
+        }
+    }
+    if (count == REGISTRY_MAX_DICTIONARIES) {
+        fprintf(stderr, "Too many dictionaries; at most %d can be registered.\n", REGISTRY_MAX_DICTIONARIES);
+        return NULL;
+    }
+
+    Dictionary *dict = NULL;
+    for (size_t i = 0; i < registry->loaded_count && dict == NULL; i++) {
+        if (same_file(registry->loaded[i]->answers_file, answers_file) &&
+            same_file(registry->loaded[i]->guesses_file, guesses_file) &&
+            same_file(registry->loaded[i]->strategy_file, strategy_file)) {
+            dict = registry->loaded[i];
+        }
+    }
+    if (dict == NULL) {
+        dict = malloc(sizeof(*dict));
+        if (dict == NULL) {
+            perror("Failed to allocate dictionary");
+            return NULL;
+        }
+        if (!dictionary_load(answers_file, guesses_file, strategy_file, dict)) {
+            free(dict);
+            return NULL;
+        }
+        registry->loaded[registry->loaded_count++] = dict;
+    }
+
+    // Readers see the entry only once count covers it
+    RegistryEntry *entry = &registry->entries[count];
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+    atomic_init(&entry->dict, dict);
+    atomic_store_explicit(&registry->count, count + 1, memory_order_release);
+    return dict;
+}
+
+// Loads the files unless some name already did; NULL (with the error
+// printed) when the name is taken, the table is full or loading fails. The
+// result stays valid while the caller is the only thread that can reload.
+const Dictionary *registry_add(DictRegistry *registry, const char *name, const char *answers_file,
+                               const char *guesses_file, const char *strategy_file) {
+    if (strlen(name) == 0 || strlen(name) >= DICTIONARY_NAME_MAX || strchr(name, ' ') != NULL) {
+        fprintf(stderr, "Invalid dictionary name '%s'.\n", name);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&registry->lock);
+    const Dictionary *dict = add_locked(registry, name, answers_file, guesses_file, strategy_file);
+    pthread_mutex_unlock(&registry->lock);
+    return dict;
+}
+
+// "NAME=ANSWERS" or "NAME=ANSWERS:GUESSES"
+const Dictionary *registry_add_spec(DictRegistry *registry, const char *spec) {
+    const char *equals = strchr(spec, '=');
+    if (equals == NULL || equals == spec || equals[1] == '\0') {
+        fprintf(stderr, "Invalid dictionary '%s'; expected NAME=ANSWERS[:GUESSES].\n", spec);
+        return NULL;
+    }
+
+    char *copy = strdup(spec);
+    if (copy == NULL) {
+        perror("Failed to allocate dictionary");
+        return NULL;
+    }
+    char *answers = copy + (equals - spec) + 1;
+    char *guesses = strchr(answers, ':');
+    copy[equals - spec] = '\0';
+    if (guesses != NULL) {
+        *guesses++ = '\0';
+    }
+
+    const Dictionary *dict =
+        registry_add(registry, copy, answers, guesses != NULL && *guesses ? guesses : NULL, NULL);
+    free(copy);
+    return dict;
+}
+
+// The current snapshot for `name` (the default for NULL) with a reference
+// the caller must release, or NULL for an unknown name. Threads other than
+// the one reloading must call this while online.
+const Dictionary *registry_acquire(DictRegistry *registry, const char *name) {
+    size_t count = atomic_load_explicit(&registry->count, memory_order_acquire);
+
+    for (size_t i = 0; i < count; i++) {
+        if (name == NULL || strcmp(registry->entries[i].name, name) == 0) {
+            Dictionary *dict = atomic_load(&registry->entries[i].dict);
+            dictionary_acquire(dict);
+            return dict;
+        }
+    }
+
+    return NULL;
+}
+
+// A quiescent-state slot for one thread, offline until it goes online
+RegistryReader *registry_reader(DictRegistry *registry) {
+    size_t slot = atomic_fetch_add(&registry->reader_count, 1);
+    if (slot >= MAX_THREADS) {
+        fprintf(stderr, "Too many registry readers.\n");
+        exit(EXIT_FAILURE);
+    }
+    RegistryReader *reader = &registry->readers[slot];
+    atomic_store(&reader->seen, REGISTRY_OFFLINE);
+    return reader;
+}
+
+// Waits until no reader can still be using a pointer it loaded before the
+// registry moved to `epoch`
+static void wait_for_readers(DictRegistry *registry, uint64_t epoch) {
+    size_t readers = atomic_load(&registry->reader_count);
+    if (readers > MAX_THREADS) {
+        readers = MAX_THREADS;
+    }
+
+    for (size_t r = 0; r < readers; r++) {
+        for (;;) {
+            uint64_t seen = atomic_load(&registry->readers[r].seen);
+            if (seen == REGISTRY_OFFLINE || seen >= epoch) {
+                break;
+            }
+            usleep(100);
+        }
+    }
+}
+
+// Rereads every dictionary from its files. A dictionary that fails to load
+// keeps its current snapshot; returns false if any did.
+bool registry_reload(DictRegistry *registry) {
+    Dictionary *retired[REGISTRY_MAX_DICTIONARIES];
+    size_t retired_count = 0;
+    bool ok = true;
+
+    pthread_mutex_lock(&registry->lock);
+    size_t count = atomic_load_explicit(&registry->count, memory_order_relaxed);
+    for (size_t i = 0; i < registry->loaded_count; i++) {
+        Dictionary *old = registry->loaded[i];
+        Dictionary *fresh = malloc(sizeof(*fresh));
+        if (fresh == NULL ||
+            !dictionary_load(old->answers_file, old->guesses_file, old->strategy_file, fresh)) {
+            free(fresh);
+            ok = false;
+            continue;
+        }
+        fresh->generation = old->generation + 1;
+
+        registry->loaded[i] = fresh;
+        for (size_t e = 0; e < count; e++) {
+            if (atomic_load_explicit(&registry->entries[e].dict, memory_order_relaxed) == old) {
+                atomic_store(&registry->entries[e].dict, fresh);
+            }
+        }
+        retired[retired_count++] = old;
+    }
+
+    uint64_t epoch = atomic_fetch_add(&registry->epoch, 1) + 1;
+    wait_for_readers(registry, epoch);
+    for (size_t i = 0; i < retired_count; i++) {
+        dictionary_release(retired[i]);
+    }
+    pthread_mutex_unlock(&registry->lock);
+    return ok;
+}
+
+// Drops the registry's references; snapshots still held by games are
+// freed when those games release them
+void registry_free(DictRegistry *registry) {
+    for (size_t i = 0; i < registry->loaded_count; i++) {
+        dictionary_release(registry->loaded[i]);
+    }
+    pthread_mutex_destroy(&registry->lock);
+    memset(registry, 0, sizeof(*registry));
+}
@@ -0,0 +1,94 @@
+// registry.h
+
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "wordle.h"
+#include "wordlist.h"
+#include "word_index.h"
+#include "strategy.h"
+
+#define REGISTRY_MAX_DICTIONARIES 32
+#define DICTIONARY_NAME_MAX 32
+#define REGISTRY_DEFAULT_NAME "default"
+#define REGISTRY_OFFLINE UINT64_MAX
+
+// One immutable snapshot of an answer list, the guesses allowed against it
+// and, when a strategy file is given, the strategy tree built for it. The
+// list holds the answers first (see wordlist.h) and valid accepts every
+// word of it. The registry holds one reference while the snapshot is
+// current and every game using it holds another, so a reload never pulls
+// a list out from under a running game.
+typedef struct {
+    char *answers_file;
+    char *guesses_file;         // NULL when the answers are the only guesses
+    char *strategy_file;        // NULL without a strategy tree
+    WordList list;
+    WordIndex valid;
+    Strategy strategy;
+    bool have_strategy;
+    uint64_t generation;        // 0 when first loaded, +1 per reload
+    atomic_size_t refs;
+} Dictionary;
+
+typedef struct {
+    char name[DICTIONARY_NAME_MAX];
+    _Atomic(Dictionary *) dict;
+} RegistryEntry;
+
+// A thread that looks dictionaries up while others may reload them. It is
+// online (seen = the registry epoch it last observed) while it may hold a
+// snapshot pointer it has not acquired, and REGISTRY_OFFLINE otherwise.
+typedef struct {
+    _Atomic uint64_t seen;
+} RegistryReader;
+
+// Dictionaries by name. Names that give the same files share one
+// snapshot; the first name added is the default. Lookups take no lock:
+// entries are published through `count` and swapped through their atomic
+// pointers, and a replaced snapshot loses the registry's reference only
+// after every online reader has passed a quiescent point.
+typedef struct {
+    RegistryEntry entries[REGISTRY_MAX_DICTIONARIES];
+    atomic_size_t count;
+    RegistryReader readers[MAX_THREADS];
+    atomic_size_t reader_count;
+    _Atomic uint64_t epoch;
+    // Writers only: registering, reloading and freeing
+    pthread_mutex_t lock;
+    Dictionary *loaded[REGISTRY_MAX_DICTIONARIES];
+    size_t loaded_count;
+} DictRegistry;
+
+// Function declarations
+bool dictionary_load(const char *answers_file, const char *guesses_file, const char *strategy_file,
+                     Dictionary *dict);
+void dictionary_free(Dictionary *dict);
+void dictionary_acquire(const Dictionary *dict);
+void dictionary_release(const Dictionary *dict);
+void registry_init(DictRegistry *registry);
+const Dictionary *registry_add(DictRegistry *registry, const char *name, const char *answers_file,
+                               const char *guesses_file, const char *strategy_file);
+const Dictionary *registry_add_spec(DictRegistry *registry, const char *spec);
+const Dictionary *registry_acquire(DictRegistry *registry, const char *name);
+RegistryReader *registry_reader(DictRegistry *registry);
+bool registry_reload(DictRegistry *registry);
+void registry_free(DictRegistry *registry);
+
+// Marks the end of a quiescent period: snapshot pointers loaded after this
+// stay valid until registry_offline, even if a reload replaces them
+static inline void registry_online(DictRegistry *registry, RegistryReader *reader) {
+    atomic_store(&reader->seen, atomic_load(&registry->epoch));
+}
+
+// The reader holds nothing it has not acquired, e.g. before blocking
+static inline void registry_offline(RegistryReader *reader) {
+    atomic_store(&reader->seen, REGISTRY_OFFLINE);
+}
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * File: render.c
+ * Description: Buffered board rendering.
+ *
+ *   Rows and whole boards are built into a caller-provided buffer in one
+ *   pass from precomputed per-score fragments, then written with a single
+ *   write() instead of several printf() calls per letter. Besides the ANSI
+ *   colour output there is a plain-text mode for logs and dumb terminals
+ *   and an emoji mode for sharing results.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "score.h"
+#include "render.h"
+
+// Fragments are stored zero-padded to a fixed width so every copy is a
+// constant-size memcpy the compiler turns into a couple of moves; the
+// cursor then advances by the real length. RENDER_SLACK in render.h
+// covers the overhang past the end of the row.
+typedef struct {
+    char text[16];
+    uint8_t length;
+} Fragment;
+
+#define FRAGMENT(s) {s, sizeof(s) - 1}
+
+// Indexed by score: 0 absent, 1 wrong position, 2 correct position
+static const Fragment color_open[3] = {
+    FRAGMENT(GREY_BACKGROUND WHITE_TEXT),
+    FRAGMENT(YELLOW_BACKGROUND WHITE_TEXT),
+    FRAGMENT(GREEN_BACKGROUND WHITE_TEXT),
+};
+static const Fragment color_close = FRAGMENT(RESET_COLOR " ");
+
+static const char plain_open[3] = {' ', '(', '['};
+static const char plain_close[3] = {' ', ')', ']'};
+
+// UTF-8 for black large square, yellow square and green square
+static const Fragment emoji[3] = {
+    FRAGMENT("\xe2\xac\x9b"),
+    FRAGMENT("\xf0\x9f\x9f\xa8"),
+    FRAGMENT("\xf0\x9f\x9f\xa9"),
+};
+
+static char *put(char *out, const Fragment *fragment) {
+    memcpy(out, fragment->text, sizeof(fragment->text));
+    return out + fragment->length;
+}
+
+// Shared by every word length; render_row passes the constant WORD_LENGTH
+// so its copy keeps a fixed trip count
+static inline size_t render_cells(char *out, const char *guess, int length, unsigned int pattern, RenderMode mode) {
+    char *p = out;
+
+    for (int i = 0; i < length; i++) {
+        int score = pattern % 3;
+        char letter = guess[i] >= 'a' && guess[i] <= 'z' ? (char)(guess[i] - 'a' + 'A') : guess[i];
+        pattern /= 3;
+
+        switch (mode) {
+        case RENDER_COLOR:
+            p = put(p, &color_open[score]);
+            *p++ = letter;
+            p = put(p, &color_close);
+            break;
+        case RENDER_PLAIN:
+            *p++ = plain_open[score];
+            *p++ = letter;
+            *p++ = plain_close[score];
+            break;
+        case RENDER_EMOJI:
+            p = put(p, &emoji[score]);
+            break;
+        }
+    }
+    *p++ = '\n';
+
+    return (size_t)(p - out);
+}
+
+size_t render_row(char *out, const char *guess, uint8_t pattern, RenderMode mode) {
+    return render_cells(out, guess, WORD_LENGTH, pattern, mode);
+}
+
+size_t render_row_variant(char *out, const char *guess, int length, uint16_t pattern, RenderMode mode) {
+    return render_cells(out, guess, length, pattern, mode);
+}
+
+size_t render_row_packed(char *out, uint32_t guess, uint8_t pattern, RenderMode mode) {
+    char word[WORD_LENGTH + 1];
+    unpack_word(guess, word);
+    return render_row(out, word, pattern, mode);
+}
+
+size_t render_board(char *out, const uint32_t *guesses, const uint8_t *patterns, int rows, RenderMode mode) {
+    size_t length = 0;
+
+    for (int r = 0; r < rows; r++) {
+        length += render_row_packed(out + length, guesses[r], patterns[r], mode);
+    }
+
+    return length;
+}
+
+size_t render_share(char *out, const uint8_t *patterns, int rows, bool solved) {
+    static const char digits[] = "0123456789";
+    char *p = out;
+
+    memcpy(p, "Wordle ", 7);
+    p += 7;
+    *p++ = solved ? digits[rows % 10] : 'X';
+    *p++ = '/';
+    *p++ = digits[MAX_ATTEMPTS % 10];
+    *p++ = '\n';
+
+    for (int r = 0; r < rows; r++) {
+        p += render_row(p, "     ", patterns[r], RENDER_EMOJI);
+    }
+
+    return (size_t)(p - out);
+}
+
+bool render_emit(int fd, const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
@@ -0,0 +1,35 @@
+// render.h
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "variant.h"
+
+typedef enum {
+    RENDER_COLOR,   // ANSI background colours, as display_result has always printed
+    RENDER_PLAIN,   // no escapes: [G]reen, (Y)ellow, plain grey letters
+    RENDER_EMOJI    // share grid: one coloured square per letter, no letters
+} RenderMode;
+
+// Buffer sizes for one rendered row and a whole board. The longest cell is
+// a grey colour cell (6 + 5 + 1 + 4 + 1 bytes); rendering may scribble up
+// to RENDER_SLACK bytes past the text it returns.
+#define RENDER_CELL_MAX 17
+#define RENDER_SLACK 16
+#define RENDER_ROW_MAX (WORD_LENGTH * RENDER_CELL_MAX + 1 + RENDER_SLACK)
+#define RENDER_BOARD_MAX (MAX_ATTEMPTS * RENDER_ROW_MAX + 32)
+#define RENDER_VARIANT_ROW_MAX (VARIANT_MAX_LENGTH * RENDER_CELL_MAX + 1 + RENDER_SLACK)
+
+// Function declarations
+size_t render_row(char *out, const char *guess, uint8_t pattern, RenderMode mode);
+size_t render_row_variant(char *out, const char *guess, int length, uint16_t pattern, RenderMode mode);
+size_t render_row_packed(char *out, uint32_t guess, uint8_t pattern, RenderMode mode);
+size_t render_board(char *out, const uint32_t *guesses, const uint8_t *patterns, int rows, RenderMode mode);
+size_t render_share(char *out, const uint8_t *patterns, int rows, bool solved);
+bool render_emit(int fd, const char *data, size_t length);
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * File: rng.c
+ * Description: Seeding and bounded sampling for the xoshiro256** generator.
+ *
+ *   Generators are seeded explicitly (through splitmix64, so any 64-bit
+ *   seed gives a well-mixed state) or from the OS entropy pool. Bounded
+ *   draws use Lemire's multiply-and-reject method, which is unbiased,
+ *   unlike rand() % n. With a process seed set (--seed), every derived
+ *   generator is reproducible from run to run.
+ */
+
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/random.h>
+#include "rng.h"
+
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(Rng *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&seed);
+    }
+}
+
+void rng_seed_entropy(Rng *rng) {
+    uint64_t seed;
+
+    if (getrandom(&seed, sizeof(seed), GRND_NONBLOCK) != (ssize_t)sizeof(seed)) {
+        // No entropy pool: mix the clock, pid and a counter so processes
+        // and threads started in the same second still differ
+        static atomic_uint_fast64_t counter;
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        seed = ((uint64_t)now.tv_sec << 32) ^ (uint64_t)now.tv_nsec ^
+               ((uint64_t)getpid() << 16) ^ atomic_fetch_add(&counter, 1) ^ (uint64_t)(uintptr_t)rng;
+    }
+    rng_seed(rng, seed);
+}
+
+void rng_split(Rng *parent, Rng *child) {
+    rng_seed(child, rng_next(parent));
+}
+
+static atomic_bool have_process_seed;
+static atomic_uint_fast64_t process_seed;
+static atomic_uint_fast64_t thread_counter;
+
+void rng_set_process_seed(uint64_t seed) {
+    atomic_store(&process_seed, seed);
+    atomic_store(&have_process_seed, true);
+}
+
+bool rng_process_seed(uint64_t *seed) {
+    *seed = atomic_load(&process_seed);
+    return atomic_load(&have_process_seed);
+}
+
+Rng *rng_thread(void) {
+    static _Thread_local Rng rng;
+    static _Thread_local bool seeded;
+
+    if (!seeded) {
+        uint64_t seed;
+        if (rng_process_seed(&seed)) {
+            // Threads are numbered in the order they first ask
+            rng_seed(&rng, seed ^ (atomic_fetch_add(&thread_counter, 1) * 0xd1b54a32d192ed03ULL));
+        } else {
+            rng_seed_entropy(&rng);
+        }
+        seeded = true;
+    }
+
+    return &rng;
+}
+
+uint64_t rng_bounded(Rng *rng, uint64_t bound) {
+    // Lemire, "Fast Random Integer Generation in an Interval" (2019)
+    unsigned __int128 product = (unsigned __int128)rng_next(rng) * bound;
+    uint64_t low = (uint64_t)product;
+
+    if (low < bound) {
+        uint64_t threshold = -bound % bound;
+        while (low < threshold) {
+            product = (unsigned __int128)rng_next(rng) * bound;
+            low = (uint64_t)product;
+        }
+    }
+
+    return (uint64_t)(product >> 64);
+}
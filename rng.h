@@ -0,0 +1,43 @@
+// rng.h
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// xoshiro256** state. Each game, session or worker owns one; nothing here
+// touches global state except rng_thread() and the process-wide seed.
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+// Function declarations
+void rng_seed(Rng *rng, uint64_t seed);
+void rng_seed_entropy(Rng *rng);
+void rng_split(Rng *parent, Rng *child);
+void rng_set_process_seed(uint64_t seed);
+bool rng_process_seed(uint64_t *seed);
+Rng *rng_thread(void);
+uint64_t rng_bounded(Rng *rng, uint64_t bound);
+
+static inline uint64_t rng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t rng_next(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+
+    return result;
+}
+
+#endif
@@ -0,0 +1,484 @@
+/*
+ * File: score.c
+ * Description: Packed-word scoring kernel for the Wordle game.
+ *
+ *   Words are packed into a 32-bit integer (five bits per lowercased letter)
+ *   and a guess is scored against a secret in two straight passes over a
+ *   per-letter count histogram, returning the whole result as one base-3
+ *   pattern byte. check_guess is a thin wrapper around this kernel for
+ *   words of letters only.
+ *   score_prepared does the same from tables built once per secret by
+ *   prepare_secret, for a secret that is scored over and over.
+ *
+ *   check_guess_batch scores one guess against a whole array of secrets
+ *   with AVX2, SSE4.1 or NEON kernels, picked at runtime from what the CPU
+ *   supports, and score_pairs scores independent (secret, guess) pairs
+ *   with AVX2 where available. Every vector kernel matches the scalar
+ *   kernel bit for bit.
+ */
+
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "score.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static const uint8_t pow3[WORD_LENGTH] = {1, 3, 9, 27, 81};
+
+uint32_t pack_word(const char *word) {
+    uint32_t packed = 0;
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        // Fold case here so the scoring kernel never has to
+        unsigned int letter = (unsigned char)(word[i] | 0x20) - 'a';
+        if (letter > 25) {
+            letter = LETTER_INVALID;
+        }
+        packed |= (uint32_t)letter << (LETTER_BITS * i);
+    }
+
+    return packed;
+}
+
+void unpack_word(uint32_t packed, char *word) {
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        unsigned int letter = (packed >> (LETTER_BITS * i)) & LETTER_MASK;
+        word[i] = letter == LETTER_INVALID ? '?' : (char)('a' + letter);
+    }
+    word[WORD_LENGTH] = '\0';
+}
+
+uint8_t score_packed(uint32_t secret, uint32_t guess) {
+    uint8_t counts[LETTER_MASK + 1];
+    unsigned int green[WORD_LENGTH];
+    unsigned int pattern = 0;
+
+    memset(counts, 0, sizeof(counts));
+
+    // First pass: mark correct positions and count the secret letters
+    // that are still available for wrong-position matches
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        unsigned int s = (secret >> (LETTER_BITS * i)) & LETTER_MASK;
+        unsigned int g = (guess >> (LETTER_BITS * i)) & LETTER_MASK;
+        green[i] = s == g;
+        counts[s] += !green[i];
+    }
+
+    // Second pass: left to right, each remaining guess letter consumes one
+    // unused occurrence from the histogram, exactly like the original
+    // letter_used scan
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        unsigned int g = (guess >> (LETTER_BITS * i)) & LETTER_MASK;
+        unsigned int yellow = !green[i] & (counts[g] != 0);
+        counts[g] -= yellow;
+        pattern += (green[i] * CORRECT_LETTER_CORRECT_POSITION +
+                    yellow * CORRECT_LETTER_WRONG_POSITION) * pow3[i];
+    }
+
+    return (uint8_t)pattern;
+}
+
+void prepare_secret(uint32_t secret, PreparedSecret *prepared) {
+    memset(prepared, 0, sizeof(*prepared));
+    prepared->secret = secret;
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        unsigned int letter = (secret >> (LETTER_BITS * i)) & LETTER_MASK;
+        prepared->letters[i] = (uint8_t)letter;
+        prepared->counts[letter]++;
+    }
+}
+
+// Low bit of each 5-bit field, for detecting equal letters in parallel
+#define FIELD_LOW_BITS 0x0108421u
+
+// The two passes of score_packed with the secret side already done: the
+// greens come from one XOR of the packed words, the histogram is copied
+// from the table instead of rebuilt, and only green letters are taken back
+// out of it before the left-to-right wrong-position pass
+uint8_t score_prepared(const PreparedSecret *prepared, uint32_t guess) {
+    // A field of secret ^ guess is zero exactly where the letters match
+    uint32_t diff = prepared->secret ^ guess;
+    uint32_t matched = ~(diff | (diff >> 1) | (diff >> 2) | (diff >> 3) | (diff >> 4)) & FIELD_LOW_BITS;
+    uint8_t counts[LETTER_MASK + 1];
+    unsigned int pattern = 0;
+
+    memcpy(counts, prepared->counts, sizeof(counts));
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        unsigned int green = (matched >> (LETTER_BITS * i)) & 1;
+        counts[prepared->letters[i]] -= green;
+        pattern += green * CORRECT_LETTER_CORRECT_POSITION * pow3[i];
+    }
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        unsigned int g = (guess >> (LETTER_BITS * i)) & LETTER_MASK;
+        unsigned int yellow = !((matched >> (LETTER_BITS * i)) & 1) & (counts[g] != 0);
+        counts[g] -= yellow;
+        pattern += yellow * CORRECT_LETTER_WRONG_POSITION * pow3[i];
+    }
+
+    return (uint8_t)pattern;
+}
+
+uint8_t scores_to_pattern(const int *scores) {
+    unsigned int pattern = 0;
+
+    for (int i = WORD_LENGTH - 1; i >= 0; i--) {
+        int score = scores[i] == CORRECT_LETTER_CORRECT_POSITION || scores[i] == CORRECT_LETTER_WRONG_POSITION
+                        ? scores[i] : 0;
+        pattern = pattern * 3 + (unsigned int)score;
+    }
+
+    return (uint8_t)pattern;
+}
+
+void pattern_to_scores(uint8_t pattern, int *scores) {
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        scores[i] = pattern % 3;
+        pattern /= 3;
+    }
+}
+
+/*
+ * Batch scoring: one guess against many packed secrets.
+ *
+ * The vector kernels evaluate the same two passes as score_packed, but with
+ * one secret per 32-bit lane. Because the guess is fixed for the whole
+ * batch, the duplicate-letter bookkeeping only depends on the guess side:
+ * guess letter i is a wrong-position match when the secret holds more
+ * non-green copies of it than the non-green copies of the same letter the
+ * guess already spent at earlier positions.
+ */
+
+typedef struct {
+    uint32_t letter[WORD_LENGTH];
+    // Bit k is set when guess letter k equals guess letter i and k < i
+    uint32_t earlier_same[WORD_LENGTH];
+} BatchGuess;
+
+static void prepare_batch_guess(uint32_t guess, BatchGuess *g) {
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        g->letter[i] = (guess >> (LETTER_BITS * i)) & LETTER_MASK;
+        g->earlier_same[i] = 0;
+        for (int k = 0; k < i; k++) {
+            if (g->letter[k] == g->letter[i]) {
+                g->earlier_same[i] |= 1u << k;
+            }
+        }
+    }
+}
+
+void check_guess_batch_scalar(uint32_t guess, const uint32_t *secrets, size_t n, uint8_t *out_patterns) {
+    for (size_t i = 0; i < n; i++) {
+        out_patterns[i] = score_packed(secrets[i], guess);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+static __m256i score8_avx2(__m256i secrets, const BatchGuess *g) {
+    const __m256i mask = _mm256_set1_epi32(LETTER_MASK);
+    __m256i letter[WORD_LENGTH], green[WORD_LENGTH], guess[WORD_LENGTH];
+    __m256i pattern = _mm256_setzero_si256();
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        letter[i] = _mm256_and_si256(secrets, mask);
+        secrets = _mm256_srli_epi32(secrets, LETTER_BITS);
+        guess[i] = _mm256_set1_epi32((int)g->letter[i]);
+        green[i] = _mm256_cmpeq_epi32(letter[i], guess[i]);
+    }
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        // Both counts are accumulated from all-ones masks, i.e. negated
+        __m256i available = _mm256_setzero_si256();
+        __m256i spent = _mm256_setzero_si256();
+        for (int j = 0; j < WORD_LENGTH; j++) {
+            available = _mm256_add_epi32(available,
+                _mm256_andnot_si256(green[j], _mm256_cmpeq_epi32(letter[j], guess[i])));
+            if (g->earlier_same[i] & (1u << j)) {
+                spent = _mm256_add_epi32(spent,
+                    _mm256_andnot_si256(green[j], _mm256_set1_epi32(-1)));
+            }
+        }
+        __m256i yellow = _mm256_andnot_si256(green[i], _mm256_cmpgt_epi32(spent, available));
+        pattern = _mm256_add_epi32(pattern,
+            _mm256_and_si256(green[i], _mm256_set1_epi32(CORRECT_LETTER_CORRECT_POSITION * pow3[i])));
+        pattern = _mm256_add_epi32(pattern,
+            _mm256_and_si256(yellow, _mm256_set1_epi32(CORRECT_LETTER_WRONG_POSITION * pow3[i])));
+    }
+
+    return pattern;
+}
+
+__attribute__((target("avx2")))
+static void check_guess_batch_avx2(uint32_t guess, const uint32_t *secrets, size_t n, uint8_t *out_patterns) {
+    BatchGuess g;
+    size_t i = 0;
+
+    prepare_batch_guess(guess, &g);
+
+    // 32 secrets per iteration, narrowed to bytes and stored in order
+    for (; i + 32 <= n; i += 32) {
+        __m256i p0 = score8_avx2(_mm256_loadu_si256((const __m256i *)(secrets + i)), &g);
+        __m256i p1 = score8_avx2(_mm256_loadu_si256((const __m256i *)(secrets + i + 8)), &g);
+        __m256i p2 = score8_avx2(_mm256_loadu_si256((const __m256i *)(secrets + i + 16)), &g);
+        __m256i p3 = score8_avx2(_mm256_loadu_si256((const __m256i *)(secrets + i + 24)), &g);
+        // packs work per 128-bit lane; the final permute restores order
+        __m256i p01 = _mm256_packus_epi32(p0, p1);
+        __m256i p23 = _mm256_packus_epi32(p2, p3);
+        __m256i bytes = _mm256_packus_epi16(p01, p23);
+        bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        _mm256_storeu_si256((__m256i *)(out_patterns + i), bytes);
+    }
+
+    for (; i < n; i++) {
+        out_patterns[i] = score_packed(secrets[i], guess);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static __m128i score4_sse41(__m128i secrets, const BatchGuess *g) {
+    const __m128i mask = _mm_set1_epi32(LETTER_MASK);
+    __m128i letter[WORD_LENGTH], green[WORD_LENGTH], guess[WORD_LENGTH];
+    __m128i pattern = _mm_setzero_si128();
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        letter[i] = _mm_and_si128(secrets, mask);
+        secrets = _mm_srli_epi32(secrets, LETTER_BITS);
+        guess[i] = _mm_set1_epi32((int)g->letter[i]);
+        green[i] = _mm_cmpeq_epi32(letter[i], guess[i]);
+    }
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        __m128i available = _mm_setzero_si128();
+        __m128i spent = _mm_setzero_si128();
+        for (int j = 0; j < WORD_LENGTH; j++) {
+            available = _mm_add_epi32(available,
+                _mm_andnot_si128(green[j], _mm_cmpeq_epi32(letter[j], guess[i])));
+            if (g->earlier_same[i] & (1u << j)) {
+                spent = _mm_add_epi32(spent, _mm_andnot_si128(green[j], _mm_set1_epi32(-1)));
+            }
+        }
+        __m128i yellow = _mm_andnot_si128(green[i], _mm_cmpgt_epi32(spent, available));
+        pattern = _mm_add_epi32(pattern,
+            _mm_and_si128(green[i], _mm_set1_epi32(CORRECT_LETTER_CORRECT_POSITION * pow3[i])));
+        pattern = _mm_add_epi32(pattern,
+            _mm_and_si128(yellow, _mm_set1_epi32(CORRECT_LETTER_WRONG_POSITION * pow3[i])));
+    }
+
+    return pattern;
+}
+
+__attribute__((target("sse4.1")))
+static void check_guess_batch_sse41(uint32_t guess, const uint32_t *secrets, size_t n, uint8_t *out_patterns) {
+    BatchGuess g;
+    size_t i = 0;
+
+    prepare_batch_guess(guess, &g);
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i p0 = score4_sse41(_mm_loadu_si128((const __m128i *)(secrets + i)), &g);
+        __m128i p1 = score4_sse41(_mm_loadu_si128((const __m128i *)(secrets + i + 4)), &g);
+        __m128i p2 = score4_sse41(_mm_loadu_si128((const __m128i *)(secrets + i + 8)), &g);
+        __m128i p3 = score4_sse41(_mm_loadu_si128((const __m128i *)(secrets + i + 12)), &g);
+        __m128i bytes = _mm_packus_epi16(_mm_packus_epi32(p0, p1), _mm_packus_epi32(p2, p3));
+        _mm_storeu_si128((__m128i *)(out_patterns + i), bytes);
+    }
+
+    for (; i < n; i++) {
+        out_patterns[i] = score_packed(secrets[i], guess);
+    }
+}
+
+/*
+ * Pair scoring: every lane has its own guess, so the earlier-same-letter
+ * masks that prepare_batch_guess hoists out of the batch loop are
+ * computed per lane from the guess letters instead.
+ */
+
+__attribute__((target("avx2")))
+static __m256i score8_pairs_avx2(__m256i secrets, __m256i guesses) {
+    const __m256i mask = _mm256_set1_epi32(LETTER_MASK);
+    __m256i letter[WORD_LENGTH], green[WORD_LENGTH], guess[WORD_LENGTH];
+    __m256i pattern = _mm256_setzero_si256();
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        letter[i] = _mm256_and_si256(secrets, mask);
+        guess[i] = _mm256_and_si256(guesses, mask);
+        secrets = _mm256_srli_epi32(secrets, LETTER_BITS);
+        guesses = _mm256_srli_epi32(guesses, LETTER_BITS);
+        green[i] = _mm256_cmpeq_epi32(letter[i], guess[i]);
+    }
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        __m256i available = _mm256_setzero_si256();
+        __m256i spent = _mm256_setzero_si256();
+        for (int j = 0; j < WORD_LENGTH; j++) {
+            available = _mm256_add_epi32(available,
+                _mm256_andnot_si256(green[j], _mm256_cmpeq_epi32(letter[j], guess[i])));
+        }
+        for (int k = 0; k < i; k++) {
+            spent = _mm256_add_epi32(spent,
+                _mm256_andnot_si256(green[k], _mm256_cmpeq_epi32(guess[k], guess[i])));
+        }
+        __m256i yellow = _mm256_andnot_si256(green[i], _mm256_cmpgt_epi32(spent, available));
+        pattern = _mm256_add_epi32(pattern,
+            _mm256_and_si256(green[i], _mm256_set1_epi32(CORRECT_LETTER_CORRECT_POSITION * pow3[i])));
+        pattern = _mm256_add_epi32(pattern,
+            _mm256_and_si256(yellow, _mm256_set1_epi32(CORRECT_LETTER_WRONG_POSITION * pow3[i])));
+    }
+
+    return pattern;
+}
+
+__attribute__((target("avx2")))
+static void score_pairs_avx2(const uint32_t *secrets, const uint32_t *guesses, size_t n, uint8_t *out_patterns) {
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i p[4];
+        for (int q = 0; q < 4; q++) {
+            p[q] = score8_pairs_avx2(_mm256_loadu_si256((const __m256i *)(secrets + i + 8 * q)),
+                                     _mm256_loadu_si256((const __m256i *)(guesses + i + 8 * q)));
+        }
+        __m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(p[0], p[1]), _mm256_packus_epi32(p[2], p[3]));
+        bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        _mm256_storeu_si256((__m256i *)(out_patterns + i), bytes);
+    }
+
+    for (; i < n; i++) {
+        out_patterns[i] = score_packed(secrets[i], guesses[i]);
+    }
+}
+#endif
+
+void score_pairs_scalar(const uint32_t *secrets, const uint32_t *guesses, size_t n, uint8_t *out_patterns) {
+    for (size_t i = 0; i < n; i++) {
+        out_patterns[i] = score_packed(secrets[i], guesses[i]);
+    }
+}
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+static uint32x4_t score4_neon(uint32x4_t secrets, const BatchGuess *g) {
+    const uint32x4_t mask = vdupq_n_u32(LETTER_MASK);
+    uint32x4_t letter[WORD_LENGTH], green[WORD_LENGTH], guess[WORD_LENGTH];
+    uint32x4_t pattern = vdupq_n_u32(0);
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        letter[i] = vandq_u32(secrets, mask);
+        secrets = vshrq_n_u32(secrets, LETTER_BITS);
+        guess[i] = vdupq_n_u32(g->letter[i]);
+        green[i] = vceqq_u32(letter[i], guess[i]);
+    }
+
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        // Subtracting all-ones masks counts upwards
+        uint32x4_t available = vdupq_n_u32(0);
+        uint32x4_t spent = vdupq_n_u32(0);
+        for (int j = 0; j < WORD_LENGTH; j++) {
+            available = vsubq_u32(available, vbicq_u32(vceqq_u32(letter[j], guess[i]), green[j]));
+            if (g->earlier_same[i] & (1u << j)) {
+                spent = vsubq_u32(spent, vmvnq_u32(green[j]));
+            }
+        }
+        uint32x4_t yellow = vbicq_u32(vcgtq_u32(available, spent), green[i]);
+        pattern = vaddq_u32(pattern,
+            vandq_u32(green[i], vdupq_n_u32(CORRECT_LETTER_CORRECT_POSITION * pow3[i])));
+        pattern = vaddq_u32(pattern,
+            vandq_u32(yellow, vdupq_n_u32(CORRECT_LETTER_WRONG_POSITION * pow3[i])));
+    }
+
+    return pattern;
+}
+
+static void check_guess_batch_neon(uint32_t guess, const uint32_t *secrets, size_t n, uint8_t *out_patterns) {
+    BatchGuess g;
+    size_t i = 0;
+
+    prepare_batch_guess(guess, &g);
+
+    for (; i + 16 <= n; i += 16) {
+        uint32x4_t p0 = score4_neon(vld1q_u32(secrets + i), &g);
+        uint32x4_t p1 = score4_neon(vld1q_u32(secrets + i + 4), &g);
+        uint32x4_t p2 = score4_neon(vld1q_u32(secrets + i + 8), &g);
+        uint32x4_t p3 = score4_neon(vld1q_u32(secrets + i + 12), &g);
+        uint16x8_t p01 = vcombine_u16(vmovn_u32(p0), vmovn_u32(p1));
+        uint16x8_t p23 = vcombine_u16(vmovn_u32(p2), vmovn_u32(p3));
+        vst1q_u8(out_patterns + i, vcombine_u8(vmovn_u16(p01), vmovn_u16(p23)));
+    }
+
+    for (; i < n; i++) {
+        out_patterns[i] = score_packed(secrets[i], guess);
+    }
+}
+#endif
+
+// Fastest first; the scalar kernel is always last and always supported
+static const BatchScorer batch_scorer_table[] = {
+#if defined(__x86_64__) || defined(__i386__)
+    {"avx2", check_guess_batch_avx2},
+    {"sse4.1", check_guess_batch_sse41},
+#endif
+#if defined(__aarch64__) || defined(__ARM_NEON)
+    {"neon", check_guess_batch_neon},
+#endif
+    {"scalar", check_guess_batch_scalar},
+};
+
+static bool batch_scorer_supported(const BatchScorer *scorer) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (strcmp(scorer->name, "avx2") == 0) {
+        return __builtin_cpu_supports("avx2");
+    }
+    if (strcmp(scorer->name, "sse4.1") == 0) {
+        return __builtin_cpu_supports("sse4.1");
+    }
+#endif
+    (void)scorer;
+    return true;
+}
+
+static pair_score_fn pair_scorer = score_pairs_scalar;
+
+static BatchScorer supported_scorers[sizeof(batch_scorer_table) / sizeof(batch_scorer_table[0])];
+static size_t supported_count;
+static pthread_once_t detect_once = PTHREAD_ONCE_INIT;
+
+static void detect_batch_scorers(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+#endif
+    for (size_t i = 0; i < sizeof(batch_scorer_table) / sizeof(batch_scorer_table[0]); i++) {
+        if (batch_scorer_supported(&batch_scorer_table[i])) {
+            supported_scorers[supported_count++] = batch_scorer_table[i];
+        }
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx2")) {
+        pair_scorer = score_pairs_avx2;
+    }
+#endif
+}
+
+size_t batch_scorers(const BatchScorer **scorers) {
+    pthread_once(&detect_once, detect_batch_scorers);
+    *scorers = supported_scorers;
+    return supported_count;
+}
+
+void check_guess_batch(uint32_t guess, const uint32_t *secrets, size_t n, uint8_t *out_patterns) {
+    // The CPU is probed once; afterwards this is a single indirect call
+    pthread_once(&detect_once, detect_batch_scorers);
+    supported_scorers[0].score(guess, secrets, n, out_patterns);
+}
+
+void score_pairs(const uint32_t *secrets, const uint32_t *guesses, size_t n, uint8_t *out_patterns) {
+    pthread_once(&detect_once, detect_batch_scorers);
+    pair_scorer(secrets, guesses, n, out_patterns);
+}
@@ -0,0 +1,54 @@
+// score.h
+
+#ifndef SCORE_H
+#define SCORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "wordle.h"
+
+// Patterns are base-3 numbers: digit i is the score of letter i
+// (0 = absent, 1 = wrong position, 2 = correct position), so every
+// 5-letter result fits in a single byte.
+#define PATTERN_COUNT 243
+#define PATTERN_SOLVED (PATTERN_COUNT - 1)
+
+// Letters are packed five bits apiece, letter i in bits [5i, 5i + 5).
+// 'a'..'z' map to 0..25; anything else maps to LETTER_INVALID.
+#define LETTER_BITS 5
+#define LETTER_MASK 0x1f
+#define LETTER_INVALID 31
+
+typedef void (*batch_score_fn)(uint32_t guess, const uint32_t *secrets, size_t n, uint8_t *out_patterns);
+typedef void (*pair_score_fn)(const uint32_t *secrets, const uint32_t *guesses, size_t n, uint8_t *out_patterns);
+
+typedef struct {
+    const char *name;
+    batch_score_fn score;
+} BatchScorer;
+
+// One secret, preprocessed for scoring many guesses against it (the daily
+// puzzle): the letter at each position and how often each letter occurs.
+// The histogram is indexed by the 5-bit letter code, so LETTER_INVALID
+// needs no special case.
+typedef struct {
+    uint32_t secret;
+    uint8_t letters[WORD_LENGTH];
+    uint8_t counts[LETTER_MASK + 1];
+} PreparedSecret;
+
+// Function declarations
+uint32_t pack_word(const char *word);
+void unpack_word(uint32_t packed, char *word);
+uint8_t score_packed(uint32_t secret, uint32_t guess);
+void prepare_secret(uint32_t secret, PreparedSecret *prepared);
+uint8_t score_prepared(const PreparedSecret *prepared, uint32_t guess);
+void pattern_to_scores(uint8_t pattern, int *scores);
+uint8_t scores_to_pattern(const int *scores);
+void check_guess_batch(uint32_t guess, const uint32_t *secrets, size_t n, uint8_t *out_patterns);
+void check_guess_batch_scalar(uint32_t guess, const uint32_t *secrets, size_t n, uint8_t *out_patterns);
+size_t batch_scorers(const BatchScorer **scorers);
+void score_pairs(const uint32_t *secrets, const uint32_t *guesses, size_t n, uint8_t *out_patterns);
+void score_pairs_scalar(const uint32_t *secrets, const uint32_t *guesses, size_t n, uint8_t *out_patterns);
+
+#endif
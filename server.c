@@ -0,0 +1,737 @@
+/*
+ * File: server.c
+ * Description: Multi-session Wordle server over TCP or Unix sockets.
+ *
+ *   Each event loop thread owns an epoll instance and a slab of fixed-size
+ *   session structs; all loops share the listening socket and the dictionary
+ *   registry (see registry.c). A session is a WordleGame (see game.c) plus
+ *   small fixed input and output buffers, so serving a guess never touches
+ *   the heap.
+ *
+ *   SIGHUP rereads every dictionary, its validation index and the strategy
+ *   tree without stopping: a dedicated thread builds the new snapshots and
+ *   swaps them into the registry. Games already running keep the snapshot
+ *   they started on; the next NEW, HARD or DAILY gets the new one. Each
+ *   event loop reports a quiescent state to the registry before it blocks,
+ *   which is all the synchronisation the swap needs.
+ *
+ *   With a game log, every won or lost game is queued in its loop's
+ *   writer, which is flushed before the loop blocks (see gamelog.c).
+ *
+ * Protocol (one command per line, responses are single lines):
+ *   on connect          -> "WORDLE <word length> <max attempts>"
+ *   <guess>             -> "<scores> PLAYING" | "<scores> WON" | "<scores> LOST <secret>"
+ *                          where <scores> is one digit per letter: 2 correct
+ *                          position, 1 wrong position, 0 absent
+ *   NEW [NAME]          -> starts a new game from the default dictionary or
+ *                          the one registered as NAME (--dict), answered
+ *                          like a connect, or "ERROR dictionary"
+ *   HARD [NAME]         -> the same for a hard-mode game
+ *   DAILY               -> starts today's shared puzzle, "WORDLE <word length>
+ *                          <max attempts> DAILY <number>", or "ERROR daily"
+ *                          when the dictionary has no schedule. "daily" is
+ *                          also a word, so once a guess has been made the
+ *                          upper-case line is that guess until the game
+ *                          ends; a first guess of "daily" is sent in lower
+ *                          case
+ *   HINT                -> "HINT <word>" from the strategy tree, or "HINT none"
+ *                          when the game's dictionary has no tree or the
+ *                          game left it
+ *   METRICS             -> counters and latency histograms of the whole
+ *                          process in the Prometheus text format (see
+ *                          metrics.c), then a "# EOF" line. The marker is
+ *                          this protocol's end of reply, not part of the
+ *                          exposition; Prometheus reads it as a comment
+ *   QUIT                -> closes the connection
+ *   errors              -> "ERROR length" | "ERROR word" | "ERROR hard" | "ERROR over" |
+ *                          "ERROR command" ("ERROR word" and "ERROR hard"
+ *                          reject a guess that is not in the list or ignores
+ *                          a hint, without using up an attempt)
+ */
+
+#define _GNU_SOURCE // accept4
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "wordle.h"
+#include "score.h"
+#include "matrix.h"
+#include "server.h"
+#include "game.h"
+#include "rng.h"
+#include "metrics.h"
+#include "registry.h"
+#include "gamelog.h"
+
+#define SESSION_INPUT_SIZE 32
+#define SESSION_OUTPUT_SIZE 256
+#define SLAB_CHUNK_SESSIONS 1024
+#define LISTENER_TAG UINT32_MAX
+#define EVENT_BATCH 256
+#define SESSION_BULK_LIMIT (1u << 20)
+
+enum {
+    SESSION_FREE,
+    SESSION_OPEN
+};
+
+typedef struct {
+    int fd;
+    uint32_t next_free;         // free-list link while unused
+    uint8_t state;
+    uint8_t in_length;
+    bool discarding;            // skipping the rest of an overlong line
+    bool overflowed;            // client stopped reading; close it
+    uint16_t out_length;
+    // Replies too big for out[] (METRICS) go to a heap buffer that is
+    // sent before out[]; anything queued earlier is moved into it first
+    char *bulk;
+    size_t bulk_length;
+    size_t bulk_sent;
+    const Dictionary *dict;     // snapshot the game plays from, referenced
+    WordleGame game;
+    char in[SESSION_INPUT_SIZE];
+    char out[SESSION_OUTPUT_SIZE];
+} Session;
+
+// Sessions live in fixed chunks that are allocated once and never freed
+// while the loop runs; a slot index names a session for epoll
+typedef struct {
+    Session **chunks;
+    size_t chunk_count;
+    size_t capacity;
+    size_t max_sessions;
+    uint32_t free_head;
+    size_t active;
+} SessionSlab;
+
+typedef struct {
+    DictRegistry *registry;
+    RegistryReader *reader;
+    DailySchedule *daily;       // NULL without a schedule in the dictionary
+    int listen_fd;
+    size_t max_sessions;
+    GameLog *log;
+    GameLogWriter *writer;      // the loop's batch, NULL without a log
+    Rng rng;
+} EventLoop;
+
+static Session *slab_get(SessionSlab *slab, uint32_t slot) {
+    return &slab->chunks[slot / SLAB_CHUNK_SESSIONS][slot % SLAB_CHUNK_SESSIONS];
+}
+
+static bool slab_grow(SessionSlab *slab) {
+    if (slab->capacity >= slab->max_sessions) {
+        return false;
+    }
+
+    Session **chunks = realloc(slab->chunks, (slab->chunk_count + 1) * sizeof(*chunks));
+    if (chunks == NULL) {
+        return false;
+    }
+    slab->chunks = chunks;
+
+    Session *chunk = calloc(SLAB_CHUNK_SESSIONS, sizeof(Session));
+    if (chunk == NULL) {
+        return false;
+    }
+    slab->chunks[slab->chunk_count++] = chunk;
+
+    // Thread the new slots onto the free list in order
+    uint32_t base = (uint32_t)slab->capacity;
+    for (uint32_t i = SLAB_CHUNK_SESSIONS; i-- > 0;) {
+        chunk[i].next_free = slab->free_head;
+        slab->free_head = base + i;
+    }
+    slab->capacity += SLAB_CHUNK_SESSIONS;
+    return true;
+}
+
+static bool slab_alloc(SessionSlab *slab, uint32_t *slot) {
+    if (slab->free_head == UINT32_MAX && !slab_grow(slab)) {
+        return false;
+    }
+
+    *slot = slab->free_head;
+    slab->free_head = slab_get(slab, *slot)->next_free;
+    slab->active++;
+    return true;
+}
+
+static void slab_release(SessionSlab *slab, uint32_t slot) {
+    Session *session = slab_get(slab, slot);
+    session->state = SESSION_FREE;
+    session->next_free = slab->free_head;
+    slab->free_head = slot;
+    slab->active--;
+}
+
+static void append_output(Session *session, const char *text, size_t length) {
+    if (session->out_length + length > SESSION_OUTPUT_SIZE) {
+        // The client is not reading its replies; disconnect it rather
+        // than growing the buffer
+        session->overflowed = true;
+        return;
+    }
+    memcpy(session->out + session->out_length, text, length);
+    session->out_length = (uint16_t)(session->out_length + length);
+}
+
+static void send_metrics(Session *session) {
+    size_t length;
+    char *text = metrics_format_alloc(&length);
+    size_t pending = session->bulk_length - session->bulk_sent;
+    size_t total = pending + session->out_length + length + sizeof("# EOF\n") - 1;
+    char *bulk = text != NULL && total <= SESSION_BULK_LIMIT ? malloc(total) : NULL;
+
+    if (bulk == NULL) {
+        free(text);
+        session->overflowed = true;
+        return;
+    }
+
+    char *p = bulk;
+    memcpy(p, session->bulk + session->bulk_sent, pending);
+    p += pending;
+    memcpy(p, session->out, session->out_length);
+    p += session->out_length;
+    memcpy(p, text, length);
+    p += length;
+    memcpy(p, "# EOF\n", sizeof("# EOF\n") - 1);
+
+    free(text);
+    free(session->bulk);
+    session->bulk = bulk;
+    session->bulk_length = total;
+    session->bulk_sent = 0;
+    session->out_length = 0;
+}
+
+// Moves the session onto a freshly acquired snapshot
+static void switch_dictionary(Session *session, const Dictionary *dict) {
+    if (session->dict != NULL) {
+        dictionary_release(session->dict);
+    }
+    session->dict = dict;
+}
+
+static void start_game(EventLoop *loop, Session *session, bool hard, const char *name) {
+    const Dictionary *dict = registry_acquire(loop->registry, name);
+    if (dict == NULL) {
+        append_output(session, "ERROR dictionary\n", 17);
+        return;
+    }
+    switch_dictionary(session, dict);
+
+    game_init(&dict->list, &loop->rng, &session->game);
+    game_set_word_index(&session->game, &dict->valid);
+    game_set_hard_mode(&session->game, hard);
+
+    char greeting[32];
+    int length = snprintf(greeting, sizeof(greeting), "WORDLE %d %d\n", WORD_LENGTH, MAX_ATTEMPTS);
+    append_output(session, greeting, (size_t)length);
+}
+
+// Every DAILY session in the process plays the same DailySecret
+static void start_daily(EventLoop *loop, Session *session) {
+    const DailySecret *daily = loop->daily != NULL ? daily_secret(loop->daily, daily_today()) : NULL;
+    if (daily == NULL) {
+        append_output(session, "ERROR daily\n", 12);
+        return;
+    }
+
+    const Dictionary *dict = registry_acquire(loop->registry, NULL);
+    switch_dictionary(session, dict);
+    game_init_daily(&dict->list, daily, &session->game);
+    game_set_word_index(&session->game, &dict->valid);
+
+    char greeting[48];
+    int length = snprintf(greeting, sizeof(greeting), "WORDLE %d %d DAILY %u\n", WORD_LENGTH, MAX_ATTEMPTS,
+                          daily->number);
+    append_output(session, greeting, (size_t)length);
+}
+
+static void submit_guess(EventLoop *loop, Session *session, const char *guess) {
+    uint8_t pattern;
+    switch (game_submit(&session->game, guess, &pattern)) {
+    case GUESS_GAME_OVER:
+        append_output(session, "ERROR over\n", 11);
+        return;
+    case GUESS_NOT_IN_LIST:
+        append_output(session, "ERROR word\n", 11);
+        return;
+    case GUESS_BREAKS_HARD_MODE:
+        append_output(session, "ERROR hard\n", 11);
+        return;
+    default:
+        break;
+    }
+
+    char reply[64];
+    int scores[WORD_LENGTH];
+    pattern_to_scores(pattern, scores);
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        reply[i] = (char)('0' + scores[i]);
+    }
+
+    if (loop->writer != NULL && game_status(&session->game) != GAME_PLAYING) {
+        gamelog_append(loop->writer, &session->game, GAMELOG_SERVER);
+    }
+
+    int length = WORD_LENGTH;
+    switch (game_status(&session->game)) {
+    case GAME_WON:
+        length += snprintf(reply + length, sizeof(reply) - length, " WON\n");
+        break;
+    case GAME_LOST: {
+        char secret[WORD_LENGTH + 1];
+        unpack_word(session->game.secret_packed, secret);
+        length += snprintf(reply + length, sizeof(reply) - length, " LOST %s\n", secret);
+        break;
+    }
+    default:
+        length += snprintf(reply + length, sizeof(reply) - length, " PLAYING\n");
+        break;
+    }
+    append_output(session, reply, (size_t)length);
+}
+
+static void send_hint(Session *session) {
+    const WordleGame *game = &session->game;
+    const Strategy *strategy = session->dict != NULL && session->dict->have_strategy ? &session->dict->strategy
+                                                                                     : NULL;
+    // A tree built without --hard may suggest guesses a hard game refuses
+    bool usable = strategy != NULL && game_status(game) == GAME_PLAYING &&
+                  (!game->hard || (strategy->header->flags & STRATEGY_HARD_MODE));
+    uint32_t hint = usable ? strategy_hint(strategy, game->guesses, game->patterns, game->attempts)
+                        : STRATEGY_NO_HINT;
+
+    char reply[32];
+    int length;
+    if (hint == STRATEGY_NO_HINT) {
+        length = snprintf(reply, sizeof(reply), "HINT none\n");
+    } else {
+        char word[WORD_LENGTH + 1];
+        unpack_word(hint, word);
+        length = snprintf(reply, sizeof(reply), "HINT %s\n", word);
+    }
+    append_output(session, reply, (size_t)length);
+}
+
+// DAILY is only a command while it cannot be a guess that matters: before
+// the first guess of a game or after its end
+static bool daily_is_command(const Session *session) {
+    return session->game.attempts == 0 || game_status(&session->game) != GAME_PLAYING;
+}
+
+// Returns false when the connection should be closed
+static bool handle_line(EventLoop *loop, Session *session, char *line, size_t length) {
+    if (length > 0 && line[length - 1] == '\r') {
+        line[--length] = '\0';
+    }
+
+    if (strcmp(line, "QUIT") == 0) {
+        return false;
+    } else if (strcmp(line, "NEW") == 0) {
+        start_game(loop, session, false, NULL);
+    } else if (strncmp(line, "NEW ", 4) == 0) {
+        start_game(loop, session, false, line + 4);
+    } else if (strcmp(line, "HINT") == 0) {
+        send_hint(session);
+    } else if (strcmp(line, "HARD") == 0) {
+        start_game(loop, session, true, NULL);
+    } else if (strncmp(line, "HARD ", 5) == 0) {
+        start_game(loop, session, true, line + 5);
+    } else if (strcmp(line, "DAILY") == 0 && daily_is_command(session)) {
+        start_daily(loop, session);
+    } else if (strcmp(line, "METRICS") == 0) {
+        send_metrics(session);
+    } else if (length == WORD_LENGTH) {
+        submit_guess(loop, session, line);
+    } else if (length > 0) {
+        append_output(session, "ERROR length\n", 13);
+    }
+
+    return true;
+}
+
+// Sends as much as the socket takes; false on a hard error
+static bool send_pending(int fd, const char *data, size_t length, size_t *sent) {
+    while (*sent < length) {
+        ssize_t n = send(fd, data + *sent, length - *sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        *sent += (size_t)n;
+    }
+    return true;
+}
+
+static bool flush_output(int epoll_fd, uint32_t slot, Session *session) {
+    size_t sent = 0;
+
+    if (session->overflowed) {
+        return false;
+    }
+
+    if (session->bulk != NULL) {
+        if (!send_pending(session->fd, session->bulk, session->bulk_length, &session->bulk_sent)) {
+            return false;
+        }
+        if (session->bulk_sent < session->bulk_length) {
+            struct epoll_event event = {EPOLLIN | EPOLLOUT, {.u32 = slot}};
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+            return true;
+        }
+        free(session->bulk);
+        session->bulk = NULL;
+        session->bulk_length = 0;
+        session->bulk_sent = 0;
+    }
+
+    while (sent < session->out_length) {
+        ssize_t n = send(session->fd, session->out + sent, session->out_length - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return false;
+            }
+            break;
+        }
+        sent += (size_t)n;
+    }
+
+    memmove(session->out, session->out + sent, session->out_length - sent);
+    session->out_length = (uint16_t)(session->out_length - sent);
+
+    // Only ask for writability while there is something left to send
+    struct epoll_event event = {EPOLLIN | (session->out_length > 0 ? EPOLLOUT : 0), {.u32 = slot}};
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+    return true;
+}
+
+static bool handle_input(EventLoop *loop, Session *session) {
+    char buffer[4096];
+
+    for (;;) {
+        ssize_t n = recv(session->fd, buffer, sizeof(buffer), 0);
+        if (n == 0) {
+            return false;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        for (ssize_t i = 0; i < n; i++) {
+            char c = buffer[i];
+            if (c == '\n') {
+                bool keep = true;
+                if (session->discarding) {
+                    append_output(session, "ERROR command\n", 14);
+                } else {
+                    session->in[session->in_length] = '\0';
+                    keep = handle_line(loop, session, session->in, session->in_length);
+                }
+                session->in_length = 0;
+                session->discarding = false;
+                if (!keep) {
+                    return false;
+                }
+            } else if (session->in_length + 1 < SESSION_INPUT_SIZE) {
+                session->in[session->in_length++] = c;
+            } else {
+                session->discarding = true;
+            }
+        }
+    }
+}
+
+static void close_session(int epoll_fd, SessionSlab *slab, uint32_t slot) {
+    Session *session = slab_get(slab, slot);
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, session->fd, NULL);
+    close(session->fd);
+    free(session->bulk);
+    session->bulk = NULL;
+    switch_dictionary(session, NULL);
+    slab_release(slab, slot);
+    metrics_add(METRIC_SESSIONS_CLOSED, 1);
+}
+
+static void accept_clients(EventLoop *loop, int epoll_fd, SessionSlab *slab) {
+    for (;;) {
+        int fd = accept4(loop->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            // EAGAIN: drained, or another loop won the race
+            return;
+        }
+
+        uint32_t slot;
+        if (!slab_alloc(slab, &slot)) {
+            close(fd);
+            continue;
+        }
+
+        Session *session = slab_get(slab, slot);
+        memset(session, 0, offsetof(Session, game));
+        session->fd = fd;
+        session->state = SESSION_OPEN;
+        metrics_add(METRIC_SESSIONS_OPENED, 1);
+        start_game(loop, session, false, NULL);
+
+        struct epoll_event event = {EPOLLIN, {.u32 = slot}};
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0 ||
+            !flush_output(epoll_fd, slot, session)) {
+            close(fd);
+            switch_dictionary(session, NULL);
+            slab_release(slab, slot);
+            metrics_add(METRIC_SESSIONS_CLOSED, 1);
+        }
+    }
+}
+
+static void *event_loop(void *arg) {
+    EventLoop *loop = arg;
+    SessionSlab slab = {NULL, 0, 0, loop->max_sessions, UINT32_MAX, 0};
+    struct epoll_event events[EVENT_BATCH];
+    GameLogWriter writer;
+
+    if (loop->log != NULL) {
+        gamelog_writer_init(&writer, loop->log);
+        loop->writer = &writer;
+    }
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        perror("Failed to create epoll instance");
+        return NULL;
+    }
+
+    // EPOLLEXCLUSIVE wakes a single loop per incoming connection
+    struct epoll_event listen_event = {EPOLLIN | EPOLLEXCLUSIVE, {.u32 = LISTENER_TAG}};
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, loop->listen_fd, &listen_event) != 0) {
+        perror("Failed to watch listening socket");
+        close(epoll_fd);
+        return NULL;
+    }
+
+    for (;;) {
+        // Blocked in epoll_wait the loop holds no unacquired snapshot, so
+        // a reload never waits on an idle loop. Games that ended in the
+        // last batch are logged first, so an idle server holds none back.
+        if (loop->writer != NULL) {
+            gamelog_flush(loop->writer);
+        }
+        registry_offline(loop->reader);
+        int ready = epoll_wait(epoll_fd, events, EVENT_BATCH, -1);
+        registry_online(loop->registry, loop->reader);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // A reader left online at an old epoch would stall every
+            // later reload in wait_for_readers
+            registry_offline(loop->reader);
+            perror("epoll_wait failed");
+            break;
+        }
+
+        for (int e = 0; e < ready; e++) {
+            uint32_t slot = events[e].data.u32;
+            if (slot == LISTENER_TAG) {
+                accept_clients(loop, epoll_fd, &slab);
+                continue;
+            }
+
+            Session *session = slab_get(&slab, slot);
+            bool keep = !(events[e].events & (EPOLLERR | EPOLLHUP)) || (events[e].events & EPOLLIN);
+            if (keep && (events[e].events & EPOLLIN)) {
+                keep = handle_input(loop, session);
+            }
+            // Replies queued before a QUIT or EOF still go out, best effort
+            if (!flush_output(epoll_fd, slot, session) || !keep) {
+                close_session(epoll_fd, &slab, slot);
+            }
+        }
+    }
+
+    if (loop->writer != NULL) {
+        gamelog_flush(loop->writer);
+        loop->writer = NULL;
+    }
+    close(epoll_fd);
+    return NULL;
+}
+
+static int open_listener(const char *spec) {
+    int fd;
+
+    if (strncmp(spec, "unix:", 5) == 0) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(spec + 5) >= sizeof(addr.sun_path)) {
+            fprintf(stderr, "Unix socket path too long: %s\n", spec + 5);
+            return -1;
+        }
+        strcpy(addr.sun_path, spec + 5);
+        unlink(addr.sun_path);
+
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            perror("Failed to bind Unix socket");
+            if (fd >= 0) {
+                close(fd);
+            }
+            return -1;
+        }
+    } else {
+        char host[256] = "0.0.0.0";
+        const char *port = spec;
+        const char *colon = strrchr(spec, ':');
+        if (colon != NULL) {
+            snprintf(host, sizeof(host), "%.*s", (int)(colon - spec), spec);
+            port = colon + 1;
+        }
+
+        struct addrinfo hints, *result;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        int status = getaddrinfo(host, port, &hints, &result);
+        if (status != 0) {
+            fprintf(stderr, "Failed to resolve %s: %s\n", spec, gai_strerror(status));
+            return -1;
+        }
+
+        fd = socket(result->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int one = 1;
+        if (fd >= 0) {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        }
+        if (fd < 0 || bind(fd, result->ai_addr, result->ai_addrlen) != 0) {
+            perror("Failed to bind TCP socket");
+            if (fd >= 0) {
+                close(fd);
+            }
+            freeaddrinfo(result);
+            return -1;
+        }
+        freeaddrinfo(result);
+    }
+
+    if (listen(fd, SOMAXCONN) != 0) {
+        perror("Failed to listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Waits for SIGHUP, which every other thread blocks, and reloads the
+// registry each time it arrives
+static void *reload_worker(void *arg) {
+    DictRegistry *registry = arg;
+    sigset_t hangup;
+    sigemptyset(&hangup);
+    sigaddset(&hangup, SIGHUP);
+
+    for (;;) {
+        int signal_number;
+        if (sigwait(&hangup, &signal_number) != 0) {
+            continue;
+        }
+
+        uint64_t start = monotonic_ns();
+        bool ok = registry_reload(registry);
+        metrics_add(METRIC_DICTIONARY_RELOADS, 1);
+        const Dictionary *dict = registry_acquire(registry, NULL);
+        printf("Reloaded dictionaries in %.3f s%s: %zu words (%zu answers), generation %llu.\n",
+               elapsed_seconds(start), ok ? "" : " (some kept their previous snapshot)", dict->list.count,
+               dict->list.answer_count, (unsigned long long)dict->generation);
+        fflush(stdout);
+        dictionary_release(dict);
+    }
+
+    return NULL;
+}
+
+int server_run(DictRegistry *registry, DailySchedule *daily, const ServerOptions *options) {
+    int threads = options->threads > 0 ? options->threads : default_thread_count();
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    int listen_fd = open_listener(options->listen);
+    if (listen_fd < 0) {
+        return EXIT_FAILURE;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    // Blocked here, SIGHUP stays blocked in every thread started below and
+    // is delivered to the reload thread's sigwait
+    sigset_t hangup;
+    sigemptyset(&hangup);
+    sigaddset(&hangup, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &hangup, NULL);
+    pthread_t reloader;
+    if (pthread_create(&reloader, NULL, reload_worker, registry) == 0) {
+        pthread_detach(reloader);
+    }
+
+    EventLoop loops[MAX_THREADS];
+    pthread_t handles[MAX_THREADS];
+
+    for (int t = 0; t < threads; t++) {
+        loops[t].registry = registry;
+        loops[t].reader = registry_reader(registry);
+        loops[t].daily = daily;
+        loops[t].listen_fd = listen_fd;
+        loops[t].max_sessions = options->max_sessions;
+        loops[t].log = options->log;
+        loops[t].writer = NULL;
+        rng_split(rng_thread(), &loops[t].rng);
+    }
+
+    const Dictionary *dict = registry_acquire(registry, NULL);
+    size_t dictionaries = atomic_load(&registry->count);
+    printf("Serving %zu words (%zu answers, %zu dictionar%s) on %s with %d event loop%s.\n",
+           dict->list.count, dict->list.answer_count, dictionaries, dictionaries == 1 ? "y" : "ies",
+           options->listen, threads, threads == 1 ? "" : "s");
+    fflush(stdout);
+    dictionary_release(dict);
+
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[started], NULL, event_loop, &loops[t]) != 0) {
+            break;
+        }
+        started++;
+    }
+    event_loop(&loops[0]);
+    for (int t = 0; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+
+    close(listen_fd);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,25 @@
+// server.h
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stddef.h>
+#include "registry.h"
+#include "strategy.h"
+#include "daily.h"
+#include "gamelog.h"
+
+#define SERVER_DEFAULT_LISTEN "127.0.0.1:7777"
+#define SERVER_DEFAULT_MAX_SESSIONS 65536
+
+typedef struct {
+    const char *listen;     // "PORT", "HOST:PORT" or "unix:PATH"
+    int threads;            // event loops, 0 for all online cores
+    size_t max_sessions;    // per event loop
+    GameLog *log;           // finished games are appended here, or NULL
+} ServerOptions;
+
+// Function declarations
+int server_run(DictRegistry *registry, DailySchedule *daily, const ServerOptions *options);
+
+#endif
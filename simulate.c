@@ -0,0 +1,223 @@
+/*
+ * File: simulate.c
+ * Description: Batch simulation of the built-in solver.
+ *
+ *   Plays the solver against every word in the list (or a random sample)
+ *   and reports the average number of guesses, the guess-count
+ *   distribution, failures, wall time and games per second. Games are
+ *   independent, so secrets are handed out to worker threads from a
+ *   shared counter and each worker keeps its own solver and tallies. A
+ *   worker's solver and game state live in its own arena, which is rewound
+ *   at every game boundary and whose high-water mark sizes one game.
+ *   With a game log, each worker batches its own records (see gamelog.c).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "wordle.h"
+#include "score.h"
+#include "solver.h"
+#include "pattern_index.h"
+#include "simulate.h"
+#include "game.h"
+#include "arena.h"
+#include "rng.h"
+#include "timing.h"
+
+typedef struct {
+    const WordList *list;
+    const PatternMatrix *matrix;
+    const uint32_t *secrets;
+    size_t secret_count;
+    size_t opener;
+    bool hard;
+    GameLog *log;
+    atomic_size_t next;
+} SimulateJob;
+
+typedef struct {
+    SimulateJob *job;
+    // solved_in[k] counts games won on guess k + 1; failures lose all six
+    size_t solved_in[MAX_ATTEMPTS];
+    size_t failures;
+    size_t guesses;
+    size_t solver_bytes;        // arena bytes held by the solver
+    size_t game_peak;           // most arena bytes any one game added
+} SimulateWorker;
+
+// Plays one game and returns the number of guesses, or 0 on failure
+static int play_game(Solver *solver, size_t secret, Arena *arena, GameLogWriter *log) {
+    WordleGame *game = arena_alloc(arena, sizeof(*game));
+    uint8_t pattern;
+
+    game_init_with_secret(solver->words, secret, game);
+    game_set_hard_mode(game, solver->hard);
+    solver_reset(solver);
+
+    while (game_status(game) == GAME_PLAYING) {
+        size_t guess = solver_next_guess(solver);
+        game_submit_packed(game, solver->words->packed[guess], &pattern);
+        solver_apply(solver, guess, pattern);
+    }
+    if (log != NULL) {
+        gamelog_append(log, game, GAMELOG_SIMULATED);
+    }
+
+    return game_status(game) == GAME_WON ? game->attempts : 0;
+}
+
+static void *simulate_worker(void *arg) {
+    SimulateWorker *worker = arg;
+    SimulateJob *job = worker->job;
+    PatternIndex index;
+    Solver solver;
+    Arena arena;
+    GameLogWriter log;
+
+    gamelog_writer_init(&log, job->log);
+    arena_init(&arena, ARENA_BLOCK_SIZE);
+    pattern_index_init(&index, job->matrix, pattern_index_capacity_for(job->matrix, PATTERN_INDEX_BUDGET));
+    solver_init(&solver, job->list, job->matrix, &arena);
+    solver_attach_index(&solver, &index);
+    solver_set_hard_mode(&solver, job->hard);
+    solver.opener = job->opener;
+    ArenaMark game_start = arena_mark(&arena);
+    worker->solver_bytes = game_start.in_use;
+
+    for (;;) {
+        size_t i = atomic_fetch_add(&job->next, 1);
+        if (i >= job->secret_count) {
+            break;
+        }
+
+        arena_release(&arena, game_start);
+        arena_reset_peak(&arena);
+        int guesses = play_game(&solver, job->secrets[i], &arena, job->log != NULL ? &log : NULL);
+        size_t used = arena_reset_peak(&arena) - game_start.in_use;
+        if (used > worker->game_peak) {
+            worker->game_peak = used;
+        }
+        if (guesses == 0) {
+            worker->failures++;
+            worker->guesses += MAX_ATTEMPTS;
+        } else {
+            worker->solved_in[guesses - 1]++;
+            worker->guesses += (size_t)guesses;
+        }
+    }
+
+    if (job->log != NULL) {
+        gamelog_flush(&log);
+    }
+    solver_free(&solver);
+    pattern_index_free(&index);
+    arena_free(&arena);
+    return NULL;
+}
+
+static uint32_t *choose_secrets(size_t count, size_t sample, Rng *rng) {
+    uint32_t *secrets = malloc(count * sizeof(uint32_t));
+    if (secrets == NULL) {
+        perror("Failed to allocate simulation");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        secrets[i] = (uint32_t)i;
+    }
+    // Partial Fisher-Yates: the first `sample` entries become the sample
+    for (size_t i = 0; i < sample && i + 1 < count; i++) {
+        size_t j = i + (size_t)rng_bounded(rng, count - i);
+        uint32_t swap = secrets[i];
+        secrets[i] = secrets[j];
+        secrets[j] = swap;
+    }
+
+    return secrets;
+}
+
+int simulate_all(const WordList *list, const PatternMatrix *matrix, const SimulateOptions *options) {
+    // Every answer is played once; guess-only words are never the secret
+    size_t answers = list->answer_count;
+    size_t games = options->sample > 0 && options->sample < answers ? options->sample : answers;
+    int threads = options->threads > 0 ? options->threads : default_thread_count();
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    uint64_t start = monotonic_ns();
+
+    // The opener is the same for every game, so search for it only once
+    Solver warmup;
+    Arena warmup_arena;
+    arena_init(&warmup_arena, ARENA_BLOCK_SIZE);
+    solver_init(&warmup, list, matrix, &warmup_arena);
+    size_t opener = solver_next_guess(&warmup);
+    solver_free(&warmup);
+    arena_free(&warmup_arena);
+
+    SimulateJob job = {list, matrix, choose_secrets(answers, games == answers ? 0 : games, rng_thread()),
+                       games, opener, options->hard, options->log, 0};
+    SimulateWorker workers[MAX_THREADS];
+    pthread_t handles[MAX_THREADS];
+    int started = 0;
+
+    memset(workers, 0, sizeof(workers[0]) * (size_t)threads);
+    for (int t = 0; t < threads; t++) {
+        workers[t].job = &job;
+    }
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[started], NULL, simulate_worker, &workers[t]) != 0) {
+            break;
+        }
+        started++;
+    }
+    simulate_worker(&workers[0]);
+    for (int t = 0; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+
+    double seconds = elapsed_seconds(start);
+
+    // Merge the per-worker tallies
+    size_t solved_in[MAX_ATTEMPTS] = {0};
+    size_t failures = 0;
+    size_t guesses = 0;
+    size_t game_peak = 0;
+    for (int t = 0; t < threads; t++) {
+        if (workers[t].game_peak > game_peak) {
+            game_peak = workers[t].game_peak;
+        }
+        for (int k = 0; k < MAX_ATTEMPTS; k++) {
+            solved_in[k] += workers[t].solved_in[k];
+        }
+        failures += workers[t].failures;
+        guesses += workers[t].guesses;
+    }
+
+    char opener_word[WORD_LENGTH + 1];
+    unpack_word(list->packed[opener], opener_word);
+    size_t solved = games - failures;
+    size_t solved_guesses = guesses - failures * MAX_ATTEMPTS;
+
+    printf("Simulated %zu games on %d thread%s (opener '%s'%s).\n", games, threads, threads == 1 ? "" : "s",
+           opener_word, options->hard ? ", hard mode" : "");
+    printf("Average guesses: %.4f (solved games only: %.4f)\n",
+           (double)guesses / games, solved > 0 ? (double)solved_guesses / solved : 0.0);
+    printf("Distribution:\n");
+    for (int k = 0; k < MAX_ATTEMPTS; k++) {
+        printf("  %d: %zu\n", k + 1, solved_in[k]);
+    }
+    printf("  X: %zu\n", failures);
+    printf("Failures: %zu\n", failures);
+    printf("Wall time: %.3f s (%.1f games/s)\n", seconds, games / seconds);
+    printf("Arena: %zu bytes of solver state per worker, peak %zu bytes per game\n",
+           workers[0].solver_bytes, game_peak);
+
+    free((void *)job.secrets);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,22 @@
+// simulate.h
+
+#ifndef SIMULATE_H
+#define SIMULATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "wordlist.h"
+#include "matrix.h"
+#include "gamelog.h"
+
+typedef struct {
+    size_t sample;      // number of secrets to play, 0 for the whole list
+    int threads;        // worker threads, 0 for all online cores
+    bool hard;          // play by hard-mode rules
+    GameLog *log;       // every game is appended here, or NULL
+} SimulateOptions;
+
+// Function declarations
+int simulate_all(const WordList *list, const PatternMatrix *matrix, const SimulateOptions *options);
+
+#endif
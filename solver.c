@@ -0,0 +1,201 @@
+/*
+ * File: solver.c
+ * Description: Entropy-maximising Wordle solver.
+ *
+ *   The set of secrets still consistent with the feedback so far is kept as
+ *   a bitset over the answers, the first answer_count words of the list
+ *   (see wordlist.h); guesses range over the whole list. Applying a feedback pattern scans the
+ *   guess's row of the pattern matrix once and ANDs the matching secrets
+ *   into the set; with a PatternIndex attached it is a single AND against
+ *   the precomputed bitset for that guess and pattern. The next guess is
+ *   the word whose 243-bucket pattern histogram over the surviving
+ *   secrets has the highest entropy, with ties going to words that could
+ *   still be the answer. In hard mode the search is restricted to guesses
+ *   the accumulated Constraints allow.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "wordle.h"
+#include "score.h"
+#include "solver.h"
+#include "metrics.h"
+
+// Buffers come from `arena` and stay valid until the caller releases it
+void solver_init(Solver *solver, const WordList *words, const PatternMatrix *matrix, Arena *arena) {
+    memset(solver, 0, sizeof(*solver));
+    solver->words = words;
+    solver->matrix = matrix;
+    solver->set_words = (words->answer_count + 63) / 64;
+    solver->opener = SOLVER_NO_GUESS;
+
+    solver->candidates = arena_alloc(arena, solver->set_words * sizeof(uint64_t));
+    solver->candidate_list = arena_alloc(arena, words->answer_count * sizeof(uint32_t));
+    solver->count_log_count = arena_alloc(arena, (words->answer_count + 1) * sizeof(double));
+
+    solver->count_log_count[0] = 0.0;
+    for (size_t c = 1; c <= words->answer_count; c++) {
+        solver->count_log_count[c] = c * log2((double)c);
+    }
+
+    solver_reset(solver);
+}
+
+void solver_attach_index(Solver *solver, PatternIndex *index) {
+    solver->index = index;
+}
+
+// The opener needs no hints, so it is shared between normal and hard mode
+void solver_set_hard_mode(Solver *solver, bool hard) {
+    solver->hard = hard;
+}
+
+void solver_reset(Solver *solver) {
+    size_t count = solver->words->answer_count;
+
+    memset(solver->candidates, 0xff, solver->set_words * sizeof(uint64_t));
+    if (count % 64 != 0) {
+        solver->candidates[solver->set_words - 1] = (UINT64_C(1) << (count % 64)) - 1;
+    }
+    solver->remaining = count;
+    constraints_init(&solver->constraints);
+}
+
+// The buffers belong to the arena; this only detaches the solver from them
+void solver_free(Solver *solver) {
+    memset(solver, 0, sizeof(*solver));
+}
+
+static void apply_indexed(Solver *solver, size_t guess, uint8_t pattern) {
+    const uint64_t *match = pattern_index_lookup(solver->index, guess, pattern);
+    size_t remaining = 0;
+
+    for (size_t w = 0; w < solver->set_words; w++) {
+        solver->candidates[w] &= match[w];
+        remaining += (size_t)__builtin_popcountll(solver->candidates[w]);
+    }
+
+    solver->remaining = remaining;
+}
+
+void solver_apply(Solver *solver, size_t guess, uint8_t pattern) {
+    constraints_update(&solver->constraints, solver->words->packed[guess], pattern);
+    if (solver->index != NULL) {
+        apply_indexed(solver, guess, pattern);
+        return;
+    }
+
+    const uint8_t *row = matrix_row(solver->matrix, guess);
+    size_t count = solver->words->answer_count;
+    size_t remaining = 0;
+
+    for (size_t w = 0; w < solver->set_words; w++) {
+        uint64_t set = solver->candidates[w];
+        if (set == 0) {
+            continue;
+        }
+
+        // Build the 64-secret match mask for this block, then AND it in
+        const uint8_t *block = row + w * 64;
+        size_t width = count - w * 64 < 64 ? count - w * 64 : 64;
+        uint64_t match = 0;
+        for (size_t b = 0; b < width; b++) {
+            match |= (uint64_t)(block[b] == pattern) << b;
+        }
+
+        set &= match;
+        solver->candidates[w] = set;
+        remaining += (size_t)__builtin_popcountll(set);
+    }
+
+    solver->remaining = remaining;
+}
+
+static size_t list_candidates(const Solver *solver, uint32_t *list) {
+    size_t n = 0;
+
+    for (size_t w = 0; w < solver->set_words; w++) {
+        uint64_t set = solver->candidates[w];
+        while (set != 0) {
+            list[n++] = (uint32_t)(w * 64 + (size_t)__builtin_ctzll(set));
+            set &= set - 1;
+        }
+    }
+
+    return n;
+}
+
+// Sum of c * log2(c) over the pattern buckets; lower means the guess
+// splits the candidates more evenly (higher entropy)
+static double bucket_cost(const Solver *solver, const uint8_t *row, const uint32_t *list, size_t n) {
+    uint32_t histogram[PATTERN_COUNT];
+    double cost = 0.0;
+
+    memset(histogram, 0, sizeof(histogram));
+    for (size_t i = 0; i < n; i++) {
+        histogram[row[list[i]]]++;
+    }
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        cost += solver->count_log_count[histogram[p]];
+    }
+
+    return cost;
+}
+
+double solver_guess_entropy(const Solver *solver, size_t guess) {
+    uint32_t *list = solver->candidate_list;
+    size_t n = list_candidates(solver, list);
+    if (n == 0) {
+        return 0.0;
+    }
+
+    double cost = bucket_cost(solver, matrix_row(solver->matrix, guess), list, n);
+    return log2((double)n) - cost / n;
+}
+
+static size_t pick_next_guess(Solver *solver) {
+    size_t count = solver->words->answer_count;
+
+    if (solver->remaining == count && solver->opener != SOLVER_NO_GUESS) {
+        return solver->opener;
+    }
+
+    uint32_t *list = solver->candidate_list;
+    size_t n = list_candidates(solver, list);
+    if (n == 0) {
+        return SOLVER_NO_GUESS;
+    }
+    if (n <= 2) {
+        // Guessing a candidate wins now or leaves exactly one
+        return list[0];
+    }
+
+    size_t best = list[0];
+    double best_cost = INFINITY;
+    for (size_t g = 0; g < solver->words->count; g++) {
+        if (solver->hard && !constraints_allows_guess(&solver->constraints, solver->words->packed[g])) {
+            continue;
+        }
+        double cost = bucket_cost(solver, matrix_row(solver->matrix, g), list, n);
+        // Equal splits favour a guess that might be the answer itself
+        if (cost < best_cost ||
+            (cost == best_cost && solver_is_candidate(solver, g) && !solver_is_candidate(solver, best))) {
+            best = g;
+            best_cost = cost;
+        }
+    }
+
+    if (n == count) {
+        solver->opener = best;
+    }
+    return best;
+}
+
+size_t solver_next_guess(Solver *solver) {
+    uint64_t start = monotonic_ns();
+    size_t guess = pick_next_guess(solver);
+    metrics_observe(HISTOGRAM_SOLVER_NEXT_GUESS, monotonic_ns() - start);
+    return guess;
+}
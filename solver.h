@@ -0,0 +1,51 @@
+// solver.h
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordlist.h"
+#include "matrix.h"
+#include "pattern_index.h"
+#include "constraints.h"
+#include "arena.h"
+
+#define SOLVER_NO_GUESS SIZE_MAX
+
+// Entropy-maximising solver over a word list. The surviving secrets are a
+// bitset over the list's answers; each observed pattern clears the bits of
+// every secret whose matrix entry for the guess disagrees.
+typedef struct {
+    const WordList *words;
+    const PatternMatrix *matrix;
+    PatternIndex *index;      // optional; filtering falls back to row scans
+    uint64_t *candidates;     // bit s set while words[s] is still possible
+    size_t set_words;         // uint64_t words per bitset
+    size_t remaining;
+    size_t opener;            // best first guess, computed once
+    bool hard;                // only consider guesses that reuse every hint
+    Constraints constraints;
+    // Scratch reused by every solver_next_guess call; like the candidate
+    // set it lives in the arena passed to solver_init
+    uint32_t *candidate_list;
+    double *count_log_count;  // c * log2(c) for c = 0 .. words->answer_count
+} Solver;
+
+// Function declarations
+void solver_init(Solver *solver, const WordList *words, const PatternMatrix *matrix, Arena *arena);
+void solver_attach_index(Solver *solver, PatternIndex *index);
+void solver_set_hard_mode(Solver *solver, bool hard);
+void solver_reset(Solver *solver);
+void solver_free(Solver *solver);
+size_t solver_next_guess(Solver *solver);
+void solver_apply(Solver *solver, size_t guess, uint8_t pattern);
+double solver_guess_entropy(const Solver *solver, size_t guess);
+
+static inline bool solver_is_candidate(const Solver *solver, size_t word) {
+    // Guess-only words are never the secret
+    return word < solver->words->answer_count && ((solver->candidates[word / 64] >> (word % 64)) & 1);
+}
+
+#endif
@@ -0,0 +1,234 @@
+/*
+ * File: startup.c
+ * Description: Constant-time secret selection and lazily loaded lists.
+ *
+ *   A plain game needs one secret before its first prompt and nothing else.
+ *   startup_pick_secret reads it with a couple of pread calls instead of
+ *   loading the list: a binary dictionary stores fixed 25-bit records, so
+ *   word i sits at bit i * 25 of the word section, and a text list can
+ *   carry a line-offset sidecar written by --build-offsets. Either way the
+ *   index is drawn with the same rng_bounded call game_init makes, so a
+ *   seeded run picks the same secret whichever path it takes. When neither
+ *   shortcut applies the caller falls back to the full load.
+ *
+ *   LazyWords defers the list and the validation index to the first guess.
+ *   A dictionary packed with --with-index never needs the list at all: its
+ *   stored bitmap is mapped directly.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "wordle.h"
+#include "score.h"
+#include "dict.h"
+#include "startup.h"
+
+static bool read_at(int fd, void *buffer, size_t length, off_t offset) {
+    return pread(fd, buffer, length, offset) == (ssize_t)length;
+}
+
+static bool pack_letters(const char *letters, uint32_t *packed) {
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        if ((unsigned char)((letters[i] | 0x20) - 'a') > 'z' - 'a') {
+            return false;
+        }
+    }
+    *packed = pack_word(letters);
+    return true;
+}
+
+static int64_t mtime_ns(const struct stat *st) {
+    return (int64_t)st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+}
+
+static bool pick_from_dict(int fd, const DictHeader *header, Rng *rng, size_t *index, uint32_t *packed) {
+    if (header->word_length != WORD_LENGTH || header->word_count == 0) {
+        return false;
+    }
+
+    size_t i = (size_t)rng_bounded(rng, header->word_count);
+    if (!dict_read_word(fd, header, i, packed)) {
+        return false;
+    }
+
+    *index = i;
+    return true;
+}
+
+static bool pick_from_offsets(int fd, const char *words_file, Rng *rng, size_t *index, uint32_t *packed) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s%s", words_file, OFFSETS_SUFFIX);
+
+    int offsets_fd = open(path, O_RDONLY);
+    if (offsets_fd < 0) {
+        return false;
+    }
+
+    OffsetsHeader header;
+    struct stat st;
+    bool ok = read_at(offsets_fd, &header, sizeof(header), 0) &&
+              memcmp(header.magic, OFFSETS_MAGIC, 4) == 0 && header.version == OFFSETS_VERSION &&
+              header.count > 0 && fstat(fd, &st) == 0 &&
+              header.source_size == (uint64_t)st.st_size && header.source_mtime_ns == mtime_ns(&st);
+
+    uint32_t offset;
+    char letters[WORD_LENGTH];
+    size_t i = 0;
+    if (ok) {
+        i = (size_t)rng_bounded(rng, header.count);
+        ok = read_at(offsets_fd, &offset, sizeof(offset), (off_t)(sizeof(header) + i * sizeof(offset))) &&
+             read_at(fd, letters, WORD_LENGTH, (off_t)offset) && pack_letters(letters, packed);
+    }
+    close(offsets_fd);
+
+    if (ok) {
+        *index = i;
+    }
+    return ok;
+}
+
+// Draws a secret without loading the list; false when the file offers no
+// shortcut (a text list without an up-to-date offsets file)
+bool startup_pick_secret(const char *words_file, Rng *rng, size_t *index, uint32_t *packed) {
+    int fd = open(words_file, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    DictHeader header;
+    bool ok;
+    if (read_at(fd, &header, sizeof(header), 0) && dict_is_binary(&header, sizeof(header))) {
+        ok = pick_from_dict(fd, &header, rng, index, packed);
+    } else {
+        ok = pick_from_offsets(fd, words_file, rng, index, packed);
+    }
+
+    close(fd);
+    return ok;
+}
+
+int startup_write_offsets(const char *words_file) {
+    int fd = open(words_file, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open file");
+        return EXIT_FAILURE;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "Failed to read %s.\n", words_file);
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("Failed to map file");
+        return EXIT_FAILURE;
+    }
+
+    if (dict_is_binary(data, size)) {
+        printf("%s is a binary dictionary; it needs no offsets file.\n", words_file);
+        munmap(data, size);
+        return EXIT_SUCCESS;
+    }
+
+    uint32_t *offsets = malloc((size / (WORD_LENGTH + 1) + 1) * sizeof(*offsets));
+    if (offsets == NULL) {
+        perror("Failed to allocate offsets");
+        munmap(data, size);
+        return EXIT_FAILURE;
+    }
+    size_t count = wordlist_text_offsets(data, size, offsets);
+    munmap(data, size);
+
+    char path[4096], tmp_path[4096 + 32];
+    snprintf(path, sizeof(path), "%s%s", words_file, OFFSETS_SUFFIX);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", path, (long)getpid());
+
+    OffsetsHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OFFSETS_MAGIC, 4);
+    header.version = OFFSETS_VERSION;
+    header.count = (uint32_t)count;
+    header.source_size = (uint64_t)st.st_size;
+    header.source_mtime_ns = mtime_ns(&st);
+
+    FILE *file = fopen(tmp_path, "wb");
+    bool ok = file != NULL && fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(offsets, sizeof(*offsets), count, file) == count;
+    if (file != NULL) {
+        ok = fclose(file) == 0 && ok;
+    }
+    free(offsets);
+
+    if (!ok || rename(tmp_path, path) != 0) {
+        perror("Failed to write offsets file");
+        remove(tmp_path);
+        return EXIT_FAILURE;
+    }
+
+    printf("Wrote %zu word offsets to %s.\n", count, path);
+    return EXIT_SUCCESS;
+}
+
+void lazy_words_init(LazyWords *words, const char *words_file, const char *answers_file) {
+    memset(words, 0, sizeof(*words));
+    words->words_file = words_file;
+    words->answers_file = answers_file;
+}
+
+// The loaded list, or NULL (with the error already printed) when it
+// cannot be read
+const WordList *lazy_words_list(LazyWords *words) {
+    if (!words->list_loaded && !words->failed) {
+        words->list_loaded = words->answers_file != NULL
+                                 ? wordlist_load_split(words->answers_file, words->words_file, &words->list)
+                                 : wordlist_load(words->words_file, &words->list);
+        words->failed = !words->list_loaded;
+    }
+    return words->list_loaded ? &words->list : NULL;
+}
+
+const WordIndex *lazy_words_index(LazyWords *words) {
+    if (!words->index_loaded && words->answers_file != NULL) {
+        // Only the joined list can tell whether the guess list's stored
+        // index covers the answers
+        const WordList *list = lazy_words_list(words);
+        if (list == NULL) {
+            return NULL;
+        }
+        word_index_open_split(words->words_file, list, &words->valid);
+        words->index_loaded = true;
+    }
+    if (!words->index_loaded) {
+        if (word_index_map(words->words_file, &words->valid)) {
+            words->index_loaded = true;
+        } else {
+            const WordList *list = lazy_words_list(words);
+            if (list == NULL) {
+                return NULL;
+            }
+            word_index_build(list, &words->valid);
+            words->index_loaded = true;
+        }
+    }
+    return &words->valid;
+}
+
+void lazy_words_free(LazyWords *words) {
+    if (words->index_loaded) {
+        word_index_free(&words->valid);
+    }
+    if (words->list_loaded) {
+        wordlist_free(&words->list);
+    }
+    memset(words, 0, sizeof(*words));
+}
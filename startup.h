@@ -0,0 +1,50 @@
+// startup.h
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordlist.h"
+#include "word_index.h"
+#include "rng.h"
+
+#define OFFSETS_MAGIC "WOFF"
+#define OFFSETS_VERSION 1
+#define OFFSETS_SUFFIX ".offsets"
+
+// Line-offset sidecar for a text list (<list>.offsets): this header, then
+// one uint32_t byte offset per word. The source size and modification
+// time must still match for the offsets to be trusted.
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t source_size;
+    int64_t source_mtime_ns;
+} OffsetsHeader;
+
+// A word list that is read from disk the first time a caller needs the
+// words or the validation index, and not before. With answers_file set,
+// words_file holds the allowed guesses (see wordlist_load_split).
+typedef struct {
+    const char *words_file;
+    const char *answers_file;
+    bool list_loaded;
+    bool index_loaded;
+    bool failed;
+    WordList list;
+    WordIndex valid;
+} LazyWords;
+
+// Function declarations
+bool startup_pick_secret(const char *words_file, Rng *rng, size_t *index, uint32_t *packed);
+int startup_write_offsets(const char *words_file);
+void lazy_words_init(LazyWords *words, const char *words_file, const char *answers_file);
+const WordList *lazy_words_list(LazyWords *words);
+const WordIndex *lazy_words_index(LazyWords *words);
+void lazy_words_free(LazyWords *words);
+
+#endif
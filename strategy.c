@@ -0,0 +1,302 @@
+/*
+ * File: strategy.c
+ * Description: Precomputed solver decision trees.
+ *
+ *   strategy_build plays the solver down every branch once, offline: at
+ *   each node it asks for the next guess, splits the surviving secrets by
+ *   the pattern they would give, and recurses into each bucket. Nodes and
+ *   edges go into two flat arrays addressed by index, written after a
+ *   small header, so the file is mapped and used in place.
+ *
+ *   At play time strategy_hint replays the game's history down the tree,
+ *   one edge lookup per guess, and returns the next guess with no scoring
+ *   at all. Games that stray from the tree simply get no hint.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "score.h"
+#include "solver.h"
+#include "pattern_index.h"
+#include "strategy.h"
+#include "arena.h"
+
+typedef struct {
+    Solver *solver;
+    const PatternMatrix *matrix;
+    Arena *arena;
+    StrategyNode *nodes;
+    size_t node_count;
+    size_t node_capacity;
+    StrategyEdge *edges;
+    size_t edge_count;
+    size_t edge_capacity;
+    uint32_t max_depth;
+} StrategyBuilder;
+
+static void *grow(void *array, size_t *capacity, size_t needed, size_t element) {
+    if (needed <= *capacity) {
+        return array;
+    }
+    size_t next = *capacity > 0 ? *capacity * 2 : 1024;
+    while (next < needed) {
+        next *= 2;
+    }
+    array = realloc(array, next * element);
+    if (array == NULL) {
+        perror("Failed to allocate strategy");
+        exit(EXIT_FAILURE);
+    }
+    *capacity = next;
+    return array;
+}
+
+// Appends the subtree for the solver's current candidates and returns its node
+static uint32_t build_node(StrategyBuilder *b, uint32_t depth) {
+    Solver *solver = b->solver;
+    size_t guess = solver_next_guess(solver);
+    uint32_t node = (uint32_t)b->node_count;
+
+    b->nodes = grow(b->nodes, &b->node_capacity, b->node_count + 1, sizeof(StrategyNode));
+    b->node_count++;
+    memset(&b->nodes[node], 0, sizeof(StrategyNode));
+    b->nodes[node].guess = solver->words->packed[guess];
+    if (depth > b->max_depth) {
+        b->max_depth = depth;
+    }
+
+    // Bucket the candidates by the feedback this guess would get
+    uint32_t histogram[PATTERN_COUNT];
+    memset(histogram, 0, sizeof(histogram));
+    const uint8_t *row = matrix_row(b->matrix, guess);
+    for (size_t w = 0; w < solver->set_words; w++) {
+        uint64_t set = solver->candidates[w];
+        while (set != 0) {
+            histogram[row[w * 64 + (size_t)__builtin_ctzll(set)]]++;
+            set &= set - 1;
+        }
+    }
+
+    uint16_t children = 0;
+    for (int p = 0; p < PATTERN_SOLVED; p++) {
+        children += histogram[p] != 0;
+    }
+    uint32_t first_edge = (uint32_t)b->edge_count;
+    b->edges = grow(b->edges, &b->edge_capacity, b->edge_count + children, sizeof(StrategyEdge));
+    b->edge_count += children;
+    b->nodes[node].first_edge = first_edge;
+    b->nodes[node].edge_count = children;
+
+    // Each branch starts from this node's state, saved once in the arena
+    ArenaMark mark = arena_mark(b->arena);
+    uint64_t *saved = arena_alloc(b->arena, solver->set_words * sizeof(uint64_t));
+    memcpy(saved, solver->candidates, solver->set_words * sizeof(uint64_t));
+    size_t remaining = solver->remaining;
+    Constraints constraints = solver->constraints;
+
+    uint32_t e = first_edge;
+    for (int p = 0; p < PATTERN_SOLVED; p++) {
+        if (histogram[p] == 0) {
+            continue;
+        }
+        solver_apply(solver, guess, (uint8_t)p);
+        uint32_t child = build_node(b, depth + 1);
+        b->edges[e].child = child;
+        b->edges[e].pattern = (uint16_t)p;
+        b->edges[e].reserved = 0;
+        e++;
+
+        memcpy(solver->candidates, saved, solver->set_words * sizeof(uint64_t));
+        solver->remaining = remaining;
+        solver->constraints = constraints;
+    }
+
+    arena_release(b->arena, mark);
+    return node;
+}
+
+static bool write_strategy(const char *path, const StrategyBuilder *b, const WordList *list, bool hard) {
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.tmp", path, (long)getpid());
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (file == NULL) {
+        perror("Failed to create strategy file");
+        return false;
+    }
+
+    StrategyHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STRATEGY_MAGIC, 4);
+    header.version = STRATEGY_VERSION;
+    header.word_length = WORD_LENGTH;
+    header.flags = hard ? STRATEGY_HARD_MODE : 0;
+    header.count = (uint32_t)list->count;
+    header.node_count = (uint32_t)b->node_count;
+    header.list_hash = hash_word_sets(list->packed, list->count, list->answer_count);
+    header.nodes_offset = sizeof(header);
+    header.edges_offset = (uint32_t)(sizeof(header) + b->node_count * sizeof(StrategyNode));
+    header.edge_count = (uint32_t)b->edge_count;
+    header.max_depth = b->max_depth;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(b->nodes, sizeof(StrategyNode), b->node_count, file) == b->node_count &&
+              fwrite(b->edges, sizeof(StrategyEdge), b->edge_count, file) == b->edge_count;
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok || rename(tmp_path, path) != 0) {
+        perror("Failed to write strategy file");
+        remove(tmp_path);
+        return false;
+    }
+
+    printf("Wrote %zu nodes and %zu edges to %s (at most %u guesses%s).\n",
+           b->node_count, b->edge_count, path, b->max_depth, hard ? ", hard mode" : "");
+    return true;
+}
+
+bool strategy_build(const WordList *list, const PatternMatrix *matrix, bool hard, const char *path) {
+    Arena arena;
+    PatternIndex index;
+    Solver solver;
+    StrategyBuilder builder;
+
+    arena_init(&arena, ARENA_BLOCK_SIZE);
+    pattern_index_init(&index, matrix, pattern_index_capacity_for(matrix, PATTERN_INDEX_BUDGET));
+    solver_init(&solver, list, matrix, &arena);
+    solver_attach_index(&solver, &index);
+    solver_set_hard_mode(&solver, hard);
+
+    memset(&builder, 0, sizeof(builder));
+    builder.solver = &solver;
+    builder.matrix = matrix;
+    builder.arena = &arena;
+    build_node(&builder, 1);
+
+    bool ok = write_strategy(path, &builder, list, hard);
+
+    free(builder.nodes);
+    free(builder.edges);
+    solver_free(&solver);
+    pattern_index_free(&index);
+    arena_free(&arena);
+    return ok;
+}
+
+// Every node's edges must lie inside the edge array and every edge must
+// name a node, so following the tree never leaves the mapping
+static bool tree_is_consistent(const StrategyHeader *header, const StrategyNode *nodes, const StrategyEdge *edges) {
+    for (size_t n = 0; n < header->node_count; n++) {
+        if ((uint64_t)nodes[n].first_edge + nodes[n].edge_count > header->edge_count) {
+            return false;
+        }
+    }
+    for (size_t e = 0; e < header->edge_count; e++) {
+        if (edges[e].child >= header->node_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool strategy_load(const char *path, const WordList *list, Strategy *strategy) {
+    memset(strategy, 0, sizeof(*strategy));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(StrategyHeader)) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    const StrategyHeader *header = map;
+    if (memcmp(header->magic, STRATEGY_MAGIC, 4) != 0 ||
+        header->version != STRATEGY_VERSION ||
+        header->word_length != WORD_LENGTH ||
+        header->count != list->count ||
+        header->list_hash != hash_word_sets(list->packed, list->count, list->answer_count) ||
+        header->node_count == 0 ||
+        header->nodes_offset + (size_t)header->node_count * sizeof(StrategyNode) > size ||
+        header->edges_offset + (size_t)header->edge_count * sizeof(StrategyEdge) > size) {
+        fprintf(stderr, "Ignoring %s: it was built for another word list.\n", path);
+        munmap(map, size);
+        return false;
+    }
+
+    const StrategyNode *nodes = (const StrategyNode *)((const char *)map + header->nodes_offset);
+    const StrategyEdge *edges = (const StrategyEdge *)((const char *)map + header->edges_offset);
+    if (!tree_is_consistent(header, nodes, edges)) {
+        fprintf(stderr, "Ignoring %s: the tree is corrupt.\n", path);
+        munmap(map, size);
+        return false;
+    }
+
+    strategy->header = header;
+    strategy->nodes = nodes;
+    strategy->edges = edges;
+    strategy->map = map;
+    strategy->map_size = size;
+    return true;
+}
+
+void strategy_free(Strategy *strategy) {
+    if (strategy->map != NULL) {
+        munmap(strategy->map, strategy->map_size);
+    }
+    memset(strategy, 0, sizeof(*strategy));
+}
+
+static const StrategyNode *follow(const Strategy *strategy, const StrategyNode *node, uint8_t pattern) {
+    // Edges are sorted by pattern; at most eight probes for 243 children
+    const StrategyEdge *edges = strategy->edges + node->first_edge;
+    size_t lo = 0;
+    size_t hi = node->edge_count;
+
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (edges[mid].pattern < pattern) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == node->edge_count || edges[lo].pattern != pattern ||
+        edges[lo].child >= strategy->header->node_count) {
+        return NULL;
+    }
+    return &strategy->nodes[edges[lo].child];
+}
+
+// Returns the packed guess the tree plays after this history, or
+// STRATEGY_NO_HINT once the game has left the tree
+uint32_t strategy_hint(const Strategy *strategy, const uint32_t *guesses, const uint8_t *patterns, int attempts) {
+    const StrategyNode *node = &strategy->nodes[0];
+
+    for (int i = 0; i < attempts; i++) {
+        if (guesses[i] != node->guess || patterns[i] == PATTERN_SOLVED) {
+            return STRATEGY_NO_HINT;
+        }
+        node = follow(strategy, node, patterns[i]);
+        if (node == NULL) {
+            return STRATEGY_NO_HINT;
+        }
+    }
+
+    return node->guess;
+}
@@ -0,0 +1,65 @@
+// strategy.h
+
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "wordlist.h"
+#include "matrix.h"
+
+#define STRATEGY_MAGIC "WSTR"
+#define STRATEGY_VERSION 1
+#define STRATEGY_NO_HINT UINT32_MAX
+
+// Header flags
+#define STRATEGY_HARD_MODE 0x01
+
+// On-disk layout: this header, the nodes, then the edges. Node 0 is the
+// root; a node's edges are contiguous, sorted by pattern, and each names
+// the node reached after that feedback. Solved patterns have no edge.
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t word_length;
+    uint32_t flags;
+    uint32_t count;             // words in the list
+    uint32_t node_count;
+    uint64_t list_hash;
+    uint32_t nodes_offset;
+    uint32_t edges_offset;
+    uint32_t edge_count;
+    uint32_t max_depth;         // most guesses any secret needs
+} StrategyHeader;
+
+typedef struct {
+    uint32_t guess;             // packed word to play at this node
+    uint32_t first_edge;
+    uint16_t edge_count;
+    uint16_t reserved;
+} StrategyNode;
+
+typedef struct {
+    uint32_t child;             // node index
+    uint16_t pattern;
+    uint16_t reserved;
+} StrategyEdge;
+
+// A mapped strategy file
+typedef struct {
+    const StrategyHeader *header;
+    const StrategyNode *nodes;
+    const StrategyEdge *edges;
+    void *map;
+    size_t map_size;
+} Strategy;
+
+// Function declarations
+bool strategy_build(const WordList *list, const PatternMatrix *matrix, bool hard, const char *path);
+bool strategy_load(const char *path, const WordList *list, Strategy *strategy);
+void strategy_free(Strategy *strategy);
+uint32_t strategy_hint(const Strategy *strategy, const uint32_t *guesses, const uint8_t *patterns, int attempts);
+
+#endif
@@ -0,0 +1,388 @@
+/*
+ * File: stream.c
+ * Description: Non-interactive batch scoring over file descriptors.
+ *
+ *   Input is one "secret guess" pair per line (any run of spaces, tabs or
+ *   commas between the words, CRLF tolerated, blank lines skipped). Pairs
+ *   that are not two five-letter alphabetic words score as
+ *   STREAM_INVALID_PATTERN in binary output and "-----" in text output,
+ *   so the output stays line-aligned with the input.
+ *
+ *   Three threads form a pipeline: a reader fills one of two input blocks
+ *   while the scorer parses the other and runs score_pairs over it, and a
+ *   writer drains one of two output blocks while the scorer fills the
+ *   other. Blocks always end on a line boundary; the reader carries a
+ *   partial trailing line over into the next block. A line longer than a
+ *   whole block scores as one invalid pair; the reader drops the rest of
+ *   it up to and including its newline.
+ */
+
+#define _GNU_SOURCE // memrchr
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "wordle.h"
+#include "score.h"
+#include "render.h"
+#include "stream.h"
+
+#define STREAM_TEXT_LINE 6
+
+// Stands in for a line too long for a block; parses as one invalid pair
+#define STREAM_OVERLONG_LINE "-\n"
+
+typedef struct {
+    char *data;
+    size_t length;
+    bool full;
+    bool last;
+} StreamSlot;
+
+// Two slots handed back and forth between one producer and one consumer
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    StreamSlot slots[2];
+} StreamChannel;
+
+typedef struct {
+    int in_fd;
+    int out_fd;
+    size_t block_size;
+    StreamChannel input;
+    StreamChannel output;
+    int read_error;             // errno of a failed read or write,
+    int write_error;            // reported once the pipeline drains
+    uint64_t bytes_in;
+} StreamPipeline;
+
+static void channel_init(StreamChannel *channel) {
+    pthread_mutex_init(&channel->lock, NULL);
+    pthread_cond_init(&channel->changed, NULL);
+    memset(channel->slots, 0, sizeof(channel->slots));
+}
+
+static void channel_destroy(StreamChannel *channel) {
+    pthread_mutex_destroy(&channel->lock);
+    pthread_cond_destroy(&channel->changed);
+}
+
+static StreamSlot *channel_wait(StreamChannel *channel, int index, bool full) {
+    StreamSlot *slot = &channel->slots[index];
+
+    pthread_mutex_lock(&channel->lock);
+    while (slot->full != full) {
+        pthread_cond_wait(&channel->changed, &channel->lock);
+    }
+    pthread_mutex_unlock(&channel->lock);
+    return slot;
+}
+
+static void channel_post(StreamChannel *channel, int index, bool full) {
+    pthread_mutex_lock(&channel->lock);
+    channel->slots[index].full = full;
+    pthread_cond_broadcast(&channel->changed);
+    pthread_mutex_unlock(&channel->lock);
+}
+
+// Fill data up to capacity, stopping early only at end of input
+static size_t read_block(int fd, char *data, size_t length, size_t capacity, bool *eof, int *error) {
+    while (length < capacity) {
+        ssize_t got = read(fd, data + length, capacity - length);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            *error = errno;
+            *eof = true;
+            break;
+        }
+        if (got == 0) {
+            *eof = true;
+            break;
+        }
+        length += (size_t)got;
+    }
+    return length;
+}
+
+static void *reader_main(void *arg) {
+    StreamPipeline *pipeline = arg;
+    char *carry = malloc(pipeline->block_size);
+    size_t carried = 0;
+    bool eof = false;
+    bool discarding = false;    // inside a line already scored as overlong
+
+    if (carry == NULL) {
+        pipeline->read_error = ENOMEM;
+        eof = true;
+    }
+
+    for (int index = 0; ; index ^= 1) {
+        StreamSlot *slot = channel_wait(&pipeline->input, index, false);
+        size_t length = carried;
+
+        memcpy(slot->data, carry, carried);
+        carried = 0;
+        if (!eof) {
+            size_t before = length;
+            length = read_block(pipeline->in_fd, slot->data, length, pipeline->block_size,
+                                &eof, &pipeline->read_error);
+            pipeline->bytes_in += length - before;
+        }
+
+        if (discarding) {
+            char *newline = memchr(slot->data, '\n', length);
+            if (newline != NULL) {
+                size_t cut = (size_t)(newline - slot->data) + 1;
+                memmove(slot->data, slot->data + cut, length - cut);
+                length -= cut;
+                discarding = false;
+            } else {
+                length = 0;
+            }
+        }
+
+        if (!eof) {
+            // Hand over whole lines only; keep the tail for the next block
+            char *newline = memrchr(slot->data, '\n', length);
+            if (newline != NULL) {
+                size_t cut = (size_t)(newline - slot->data) + 1;
+                carried = length - cut;
+                memcpy(carry, slot->data + cut, carried);
+                length = cut;
+            } else if (length == pipeline->block_size) {
+                // The whole block is one line: score it once and skip the
+                // rest of it in the blocks that follow
+                length = strlen(STREAM_OVERLONG_LINE);
+                memcpy(slot->data, STREAM_OVERLONG_LINE, length);
+                discarding = true;
+            } else {
+                // Only the start of a line is left after skipping one
+                carried = length;
+                memcpy(carry, slot->data, carried);
+                length = 0;
+            }
+        }
+
+        slot->length = length;
+        slot->last = eof;
+        channel_post(&pipeline->input, index, true);
+        if (eof) {
+            break;
+        }
+    }
+
+    free(carry);
+    return NULL;
+}
+
+static void *writer_main(void *arg) {
+    StreamPipeline *pipeline = arg;
+
+    for (int index = 0; ; index ^= 1) {
+        StreamSlot *slot = channel_wait(&pipeline->output, index, true);
+        bool last = slot->last;
+
+        // After a failed write keep draining so the scorer never blocks
+        if (pipeline->write_error == 0 && !render_emit(pipeline->out_fd, slot->data, slot->length)) {
+            pipeline->write_error = errno;
+        }
+        channel_post(&pipeline->output, index, false);
+        if (last) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static bool is_separator(char c) {
+    return c == ' ' || c == '\t' || c == ',';
+}
+
+static bool is_letter(char c) {
+    return (unsigned char)((c | 0x20) - 'a') < 26;
+}
+
+// Parse one field of exactly WORD_LENGTH letters starting at *p
+static bool parse_word(const char **p, const char *end, uint32_t *packed) {
+    const char *word = *p;
+
+    while (*p < end && !is_separator(**p) && **p != '\r') {
+        (*p)++;
+    }
+    if (*p - word != WORD_LENGTH) {
+        return false;
+    }
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        if (!is_letter(word[i])) {
+            return false;
+        }
+    }
+    *packed = pack_word(word);
+    return true;
+}
+
+static void skip_separators(const char **p, const char *end) {
+    while (*p < end && is_separator(**p)) {
+        (*p)++;
+    }
+}
+
+// Split a block into pairs; returns the number of non-blank lines
+static size_t parse_block(const char *data, size_t length, uint32_t *secrets, uint32_t *guesses, bool *valid) {
+    const char *end = data + length;
+    size_t n = 0;
+
+    while (data < end) {
+        const char *line_end = memchr(data, '\n', (size_t)(end - data));
+        if (line_end == NULL) {
+            line_end = end;
+        }
+
+        const char *p = data;
+        skip_separators(&p, line_end);
+        if (p < line_end && !(p + 1 == line_end && *p == '\r')) {
+            bool ok = parse_word(&p, line_end, &secrets[n]);
+            skip_separators(&p, line_end);
+            ok = ok && parse_word(&p, line_end, &guesses[n]);
+            skip_separators(&p, line_end);
+            if (p < line_end && *p == '\r') {
+                p++;
+            }
+            valid[n] = ok && p == line_end;
+            if (!valid[n]) {
+                secrets[n] = 0;
+                guesses[n] = 0;
+            }
+            n++;
+        }
+
+        data = line_end + 1;
+    }
+
+    return n;
+}
+
+static char text_lines[PATTERN_COUNT][STREAM_TEXT_LINE];
+
+static void init_text_lines(void) {
+    for (int pattern = 0; pattern < PATTERN_COUNT; pattern++) {
+        int value = pattern;
+        for (int i = 0; i < WORD_LENGTH; i++) {
+            text_lines[pattern][i] = (char)('0' + value % 3);
+            value /= 3;
+        }
+        text_lines[pattern][WORD_LENGTH] = '\n';
+    }
+}
+
+static size_t format_block(char *out, const uint8_t *patterns, const bool *valid, size_t n, StreamFormat format) {
+    if (format == STREAM_BINARY) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = valid[i] ? (char)patterns[i] : (char)STREAM_INVALID_PATTERN;
+        }
+        return n;
+    }
+
+    char *p = out;
+    for (size_t i = 0; i < n; i++) {
+        if (valid[i]) {
+            memcpy(p, text_lines[patterns[i]], STREAM_TEXT_LINE);
+        } else {
+            memcpy(p, "-----\n", STREAM_TEXT_LINE);
+        }
+        p += STREAM_TEXT_LINE;
+    }
+    return (size_t)(p - out);
+}
+
+int score_stream(int in_fd, int out_fd, const StreamOptions *options, StreamStats *stats) {
+    StreamPipeline pipeline = {
+        .in_fd = in_fd,
+        .out_fd = out_fd,
+        .block_size = options->block_size ? options->block_size : STREAM_BLOCK_SIZE,
+    };
+    // Every non-blank line is at least one character plus its newline
+    size_t max_pairs = pipeline.block_size / 2 + 1;
+    uint32_t *secrets = malloc(max_pairs * sizeof(*secrets));
+    uint32_t *guesses = malloc(max_pairs * sizeof(*guesses));
+    uint8_t *patterns = malloc(max_pairs);
+    bool *valid = malloc(max_pairs * sizeof(*valid));
+    bool allocated = secrets && guesses && patterns && valid;
+
+    channel_init(&pipeline.input);
+    channel_init(&pipeline.output);
+    for (int i = 0; i < 2; i++) {
+        pipeline.input.slots[i].data = malloc(pipeline.block_size);
+        pipeline.output.slots[i].data = malloc(max_pairs * STREAM_TEXT_LINE);
+        allocated = allocated && pipeline.input.slots[i].data && pipeline.output.slots[i].data;
+    }
+
+    if (!allocated) {
+        perror("Error allocating stream buffers");
+        exit(EXIT_FAILURE);
+    }
+
+    init_text_lines();
+    memset(stats, 0, sizeof(*stats));
+
+    pthread_t reader, writer;
+    if (pthread_create(&reader, NULL, reader_main, &pipeline) != 0 ||
+        pthread_create(&writer, NULL, writer_main, &pipeline) != 0) {
+        perror("Error starting stream threads");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int index = 0; ; index ^= 1) {
+        StreamSlot *in = channel_wait(&pipeline.input, index, true);
+        bool last = in->last;
+        size_t n = parse_block(in->data, in->length, secrets, guesses, valid);
+        channel_post(&pipeline.input, index, false);
+
+        score_pairs(secrets, guesses, n, patterns);
+
+        StreamSlot *out = channel_wait(&pipeline.output, index, false);
+        out->length = format_block(out->data, patterns, valid, n, options->format);
+        out->last = last;
+        channel_post(&pipeline.output, index, true);
+
+        stats->pairs += n;
+        for (size_t i = 0; i < n; i++) {
+            stats->invalid += !valid[i];
+        }
+        if (last) {
+            break;
+        }
+    }
+
+    pthread_join(reader, NULL);
+    pthread_join(writer, NULL);
+    stats->bytes_in = pipeline.bytes_in;
+
+    if (pipeline.read_error != 0) {
+        fprintf(stderr, "Error reading pairs: %s\n", strerror(pipeline.read_error));
+    }
+    if (pipeline.write_error != 0) {
+        fprintf(stderr, "Error writing patterns: %s\n", strerror(pipeline.write_error));
+    }
+
+    for (int i = 0; i < 2; i++) {
+        free(pipeline.input.slots[i].data);
+        free(pipeline.output.slots[i].data);
+    }
+    channel_destroy(&pipeline.input);
+    channel_destroy(&pipeline.output);
+    free(secrets);
+    free(guesses);
+    free(patterns);
+    free(valid);
+
+    return pipeline.read_error || pipeline.write_error ? EXIT_FAILURE : EXIT_SUCCESS;
+}
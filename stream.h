@@ -0,0 +1,31 @@
+// stream.h
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define STREAM_BLOCK_SIZE (1u << 20)
+#define STREAM_INVALID_PATTERN 0xFF
+
+typedef enum {
+    STREAM_TEXT,        // one line of five 0/1/2 digits per pair
+    STREAM_BINARY       // one pattern byte per pair (base 3, 2 = green)
+} StreamFormat;
+
+typedef struct {
+    StreamFormat format;
+    size_t block_size;      // input bytes per block, 0 for STREAM_BLOCK_SIZE
+} StreamOptions;
+
+typedef struct {
+    uint64_t pairs;
+    uint64_t invalid;
+    uint64_t bytes_in;
+} StreamStats;
+
+// Function declarations
+int score_stream(int in_fd, int out_fd, const StreamOptions *options, StreamStats *stats);
+
+#endif
@@ -0,0 +1,19 @@
+// timing.h
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdint.h>
+#include <time.h>
+
+static inline uint64_t monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static inline double elapsed_seconds(uint64_t start_ns) {
+    return (monotonic_ns() - start_ns) / 1e9;
+}
+
+#endif
@@ -0,0 +1,392 @@
+/*
+ * File: tools/bench.c
+ * Description: Micro-benchmarks for the scoring, loading, rendering and
+ *   solver hot paths.
+ *
+ *   Every benchmark runs a fixed batch of operations many times and reports
+ *   the mean cost per operation, throughput, and the p50/p99 of the
+ *   per-batch cost. Results are printed as an aligned table, or as one JSON
+ *   object per line with --json for tracking over time.
+ *
+ * Usage:
+ *   wordle-bench [--words FILE] [--reps N] [--json]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "wordle.h"
+#include "score.h"
+#include "wordlist.h"
+#include "dict.h"
+#include "matrix.h"
+#include "solver.h"
+#include "render.h"
+#include "variant.h"
+#include "arena.h"
+#include "timing.h"
+#include "reference.h"
+
+typedef struct {
+    size_t reps;
+    bool json;
+} BenchConfig;
+
+// Keeps results observable so the compiler cannot drop the measured work
+static volatile uint64_t sink;
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const BenchConfig *config, const char *name, double *ns_per_op, size_t reps, size_t ops_per_rep) {
+    double total = 0.0;
+    for (size_t r = 0; r < reps; r++) {
+        total += ns_per_op[r];
+    }
+    qsort(ns_per_op, reps, sizeof(double), compare_doubles);
+
+    double mean = total / reps;
+    double p50 = ns_per_op[reps / 2];
+    double p99 = ns_per_op[(reps * 99) / 100 < reps ? (reps * 99) / 100 : reps - 1];
+    double ops_per_sec = mean > 0.0 ? 1e9 / mean : 0.0;
+
+    if (config->json) {
+        printf("{\"bench\":\"%s\",\"reps\":%zu,\"ops_per_rep\":%zu,\"ns_per_op\":%.3f,"
+               "\"ops_per_sec\":%.1f,\"p50_ns\":%.3f,\"p99_ns\":%.3f}\n",
+               name, reps, ops_per_rep, mean, ops_per_sec, p50, p99);
+    } else {
+        printf("%-28s %12.2f ns/op %14.0f ops/s   p50 %10.2f   p99 %10.2f\n",
+               name, mean, ops_per_sec, p50, p99);
+    }
+}
+
+static double *allocate_samples(size_t reps) {
+    double *samples = malloc(reps * sizeof(double));
+    if (samples == NULL) {
+        perror("Failed to allocate samples");
+        exit(EXIT_FAILURE);
+    }
+    return samples;
+}
+
+static void bench_scoring(const BenchConfig *config, const WordList *list) {
+    size_t n = list->count;
+    double *samples = allocate_samples(config->reps);
+    char (*words)[WORD_LENGTH + 1] = malloc(n * sizeof(*words));
+    uint8_t *patterns = malloc(n);
+    if (words == NULL || patterns == NULL) {
+        perror("Failed to allocate benchmark");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < n; i++) {
+        unpack_word(list->packed[i], words[i]);
+    }
+
+    // Each batch scores one guess (rotating through the list) against
+    // every secret
+    uint64_t acc = 0;
+    int scores[WORD_LENGTH];
+
+    for (size_t r = 0; r < config->reps; r++) {
+        const char *guess = words[r % n];
+        uint64_t start = monotonic_ns();
+        for (size_t s = 0; s < n; s++) {
+            reference_check_guess(words[s], guess, scores);
+            acc += (uint64_t)scores[0] + (uint64_t)scores[4];
+        }
+        samples[r] = (double)(monotonic_ns() - start) / n;
+    }
+    report(config, "check_guess_reference", samples, config->reps, n);
+
+    for (size_t r = 0; r < config->reps; r++) {
+        const char *guess = words[r % n];
+        uint64_t start = monotonic_ns();
+        for (size_t s = 0; s < n; s++) {
+            check_guess(words[s], guess, scores);
+            acc += (uint64_t)scores[0] + (uint64_t)scores[4];
+        }
+        samples[r] = (double)(monotonic_ns() - start) / n;
+    }
+    report(config, "check_guess", samples, config->reps, n);
+
+    for (size_t r = 0; r < config->reps; r++) {
+        uint32_t guess = list->packed[r % n];
+        uint64_t start = monotonic_ns();
+        for (size_t s = 0; s < n; s++) {
+            acc += score_packed(list->packed[s], guess);
+        }
+        samples[r] = (double)(monotonic_ns() - start) / n;
+    }
+    report(config, "score_packed", samples, config->reps, n);
+
+    // One prepared secret (rotating through the list) against every guess
+    for (size_t r = 0; r < config->reps; r++) {
+        PreparedSecret prepared;
+        prepare_secret(list->packed[r % n], &prepared);
+        uint64_t start = monotonic_ns();
+        for (size_t g = 0; g < n; g++) {
+            acc += score_prepared(&prepared, list->packed[g]);
+        }
+        samples[r] = (double)(monotonic_ns() - start) / n;
+    }
+    report(config, "score_prepared", samples, config->reps, n);
+
+    const BatchScorer *scorers;
+    size_t scorer_count = batch_scorers(&scorers);
+    for (size_t k = 0; k < scorer_count; k++) {
+        for (size_t r = 0; r < config->reps; r++) {
+            uint64_t start = monotonic_ns();
+            scorers[k].score(list->packed[r % n], list->packed, n, patterns);
+            samples[r] = (double)(monotonic_ns() - start) / n;
+            acc += patterns[r % n];
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "check_guess_batch/%s", scorers[k].name);
+        report(config, name, samples, config->reps, n);
+    }
+
+    // Independent pairs, as --score-stream sees them: guesses rotated
+    // against the list so every lane has a different guess
+    uint32_t *pair_guesses = malloc(n * sizeof(uint32_t));
+    if (pair_guesses == NULL) {
+        perror("Failed to allocate benchmark");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t w = 0; w < n; w++) {
+        pair_guesses[w] = list->packed[(w * 7 + 1) % n];
+    }
+    for (size_t r = 0; r < config->reps; r++) {
+        uint64_t start = monotonic_ns();
+        score_pairs(list->packed, pair_guesses, n, patterns);
+        samples[r] = (double)(monotonic_ns() - start) / n;
+        acc += patterns[r % n];
+    }
+    report(config, "score_pairs", samples, config->reps, n);
+    free(pair_guesses);
+
+    // The generated per-length kernels, on words spliced from the list so
+    // every length sees the same letter statistics
+    uint64_t *variant_words = malloc(n * sizeof(uint64_t));
+    uint16_t *variant_patterns = malloc(n * sizeof(uint16_t));
+    if (variant_words == NULL || variant_patterns == NULL) {
+        perror("Failed to allocate benchmark");
+        exit(EXIT_FAILURE);
+    }
+    for (int length = VARIANT_MIN_LENGTH; length <= VARIANT_MAX_LENGTH; length++) {
+        const WordVariant *variant = word_variant(length);
+        for (size_t w = 0; w < n; w++) {
+            char word[2 * WORD_LENGTH];
+            memcpy(word, wordlist_word(list, w), WORD_LENGTH);
+            memcpy(word + WORD_LENGTH, wordlist_word(list, (w + 1) % n), WORD_LENGTH);
+            variant_words[w] = variant->pack(word);
+        }
+        for (size_t r = 0; r < config->reps; r++) {
+            uint64_t start = monotonic_ns();
+            variant->score_batch(variant_words[r % n], variant_words, n, variant_patterns);
+            samples[r] = (double)(monotonic_ns() - start) / n;
+            acc += variant_patterns[r % n];
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "score_variant/%d", length);
+        report(config, name, samples, config->reps, n);
+    }
+    free(variant_words);
+    free(variant_patterns);
+
+    sink = acc;
+    free(words);
+    free(patterns);
+    free(samples);
+}
+
+static void bench_loading(const BenchConfig *config, const char *words_file, const WordList *list) {
+    size_t reps = config->reps < 200 ? config->reps : 200;
+    double *samples = allocate_samples(reps);
+    char dict_path[] = "/tmp/wordle-bench-XXXXXX";
+    int fd = mkstemp(dict_path);
+    if (fd < 0) {
+        perror("Failed to create temporary dictionary");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    if (!dict_write(dict_path, list->packed, list->count, DICT_HAS_LETTER_FREQ, NULL)) {
+        exit(EXIT_FAILURE);
+    }
+
+    WordList loaded;
+    DictView view;
+    const char *paths[2] = {words_file, dict_path};
+    const char *names[2] = {"load_text", "load_binary"};
+
+    for (int k = 0; k < 2; k++) {
+        for (size_t r = 0; r < reps; r++) {
+            uint64_t start = monotonic_ns();
+            if (!wordlist_load(paths[k], &loaded)) {
+                exit(EXIT_FAILURE);
+            }
+            sink = loaded.packed[loaded.count - 1];
+            wordlist_free(&loaded);
+            samples[r] = (double)(monotonic_ns() - start);
+        }
+        report(config, names[k], samples, reps, 1);
+    }
+
+    for (size_t r = 0; r < reps; r++) {
+        uint64_t start = monotonic_ns();
+        if (!dict_map(dict_path, &view)) {
+            exit(EXIT_FAILURE);
+        }
+        sink = dict_word(&view, view.count - 1);
+        dict_unmap(&view);
+        samples[r] = (double)(monotonic_ns() - start);
+    }
+    report(config, "map_binary", samples, reps, 1);
+
+    remove(dict_path);
+    free(samples);
+}
+
+static void bench_rendering(const BenchConfig *config, const WordList *list) {
+    size_t rows = 256;
+    double *samples = allocate_samples(config->reps);
+    char word[WORD_LENGTH + 1];
+    int scores[WORD_LENGTH];
+
+    // Render into /dev/null so the terminal does not dominate the numbers
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (saved_stdout < 0 || devnull < 0) {
+        perror("Failed to redirect output");
+        exit(EXIT_FAILURE);
+    }
+    dup2(devnull, STDOUT_FILENO);
+
+    for (size_t r = 0; r < config->reps; r++) {
+        uint64_t start = monotonic_ns();
+        for (size_t i = 0; i < rows; i++) {
+            size_t w = (r * rows + i) % list->count;
+            unpack_word(list->packed[w], word);
+            pattern_to_scores((uint8_t)(w % PATTERN_COUNT), scores);
+            display_result(word, scores);
+        }
+        fflush(stdout);
+        samples[r] = (double)(monotonic_ns() - start) / rows;
+    }
+
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+
+    report(config, "display_result", samples, config->reps, rows);
+
+    // The same rows built into one buffer, with and without the write
+    char board[RENDER_BOARD_MAX];
+    uint8_t patterns[MAX_ATTEMPTS];
+    const uint32_t *guesses = list->packed;
+    for (int k = 0; k < MAX_ATTEMPTS; k++) {
+        patterns[k] = (uint8_t)(k * 40);
+    }
+
+    for (size_t r = 0; r < config->reps; r++) {
+        uint64_t start = monotonic_ns();
+        size_t length = 0;
+        for (size_t i = 0; i < rows; i += MAX_ATTEMPTS) {
+            length += render_board(board, guesses + (i % (list->count - MAX_ATTEMPTS)), patterns,
+                                   MAX_ATTEMPTS, RENDER_COLOR);
+        }
+        samples[r] = (double)(monotonic_ns() - start) / rows;
+        sink = length;
+    }
+    report(config, "render_board", samples, config->reps, rows);
+
+    for (size_t r = 0; r < config->reps; r++) {
+        uint64_t start = monotonic_ns();
+        for (size_t i = 0; i < rows; i += MAX_ATTEMPTS) {
+            size_t length = render_board(board, guesses + (i % (list->count - MAX_ATTEMPTS)), patterns,
+                                         MAX_ATTEMPTS, RENDER_COLOR);
+            render_emit(devnull, board, length);
+        }
+        samples[r] = (double)(monotonic_ns() - start) / rows;
+    }
+    report(config, "render_board+write", samples, config->reps, rows);
+
+    close(devnull);
+    free(samples);
+}
+
+static void bench_solver(const BenchConfig *config, const WordList *list) {
+    size_t reps = config->reps < 100 ? config->reps : 100;
+    double *samples = allocate_samples(reps);
+    PatternMatrix matrix;
+    Solver solver;
+    Arena arena;
+
+    arena_init(&arena, ARENA_BLOCK_SIZE);
+    matrix_open(PATTERN_CACHE_FILE, list->packed, list->count, list->answer_count, &matrix);
+    solver_init(&solver, list, &matrix, &arena);
+
+    // Uncached opener search over the full list
+    for (size_t r = 0; r < reps && r < 10; r++) {
+        solver.opener = SOLVER_NO_GUESS;
+        uint64_t start = monotonic_ns();
+        sink = solver_next_guess(&solver);
+        samples[r] = (double)(monotonic_ns() - start);
+    }
+    report(config, "solver_opener", samples, reps < 10 ? reps : 10, 1);
+
+    // Second-guess search after the opener, against rotating secrets
+    size_t opener = solver_next_guess(&solver);
+    for (size_t r = 0; r < reps; r++) {
+        size_t secret = (r * 7919) % list->count;
+        solver_reset(&solver);
+        solver_apply(&solver, opener, matrix_lookup(&matrix, opener, secret));
+        uint64_t start = monotonic_ns();
+        sink = solver_next_guess(&solver);
+        samples[r] = (double)(monotonic_ns() - start);
+    }
+    report(config, "solver_next_guess", samples, reps, 1);
+
+    solver_free(&solver);
+    arena_free(&arena);
+    matrix_free(&matrix);
+    free(samples);
+}
+
+int main(int argc, char **argv) {
+    BenchConfig config = {1000, false};
+    const char *words_file = WORD_LIST_FILE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            config.json = true;
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            config.reps = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            words_file = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--words FILE] [--reps N] [--json]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (config.reps == 0) {
+        config.reps = 1;
+    }
+
+    WordList list;
+    if (!wordlist_load(words_file, &list)) {
+        return EXIT_FAILURE;
+    }
+
+    bench_scoring(&config, &list);
+    bench_loading(&config, words_file, &list);
+    bench_rendering(&config, &list);
+    bench_solver(&config, &list);
+
+    wordlist_free(&list);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,632 @@
+/*
+ * File: tools/loadgen.c
+ * Description: Load generator that plays the built-in solver against a
+ *   running `wordle --server`.
+ *
+ *   Every simulated player is one connection and a small state machine:
+ *   wait for the greeting, send the next guess, wait for its reply, and on
+ *   WON or LOST start over with NEW (HARD with --hard). Players are spread
+ *   over a few driver threads, each multiplexing its share with one epoll
+ *   instance, so 100k players cost 100k sockets and about 100 bytes each,
+ *   not 100k threads or stacks.
+ *
+ *   The solver runs from its precomputed strategy tree (see strategy.c),
+ *   mapped once and shared read-only by every player: choosing a guess is
+ *   strategy_hint over the player's own history, a handful of edge lookups
+ *   with no scoring, so the client stays far cheaper than the server it
+ *   measures. A player whose game leaves the tree (a server playing
+ *   another list) starts a new game and is counted as a stray.
+ *
+ *   Players connect CONNECT_WINDOW at a time per thread. Once all are
+ *   connected the measurement starts: every command's round trip, from the
+ *   write to the reply line, goes into a log-linear latency histogram (16
+ *   buckets per power of two, so percentiles are exact to 1/16), and the
+ *   guesses answered are counted for the sustained rate.
+ *
+ *   One client address reaches one TCP port through at most ~28k ephemeral
+ *   ports; past that, serve and connect on a Unix socket.
+ *
+ * Usage:
+ *   wordle-loadgen [--connect PORT|HOST:PORT|unix:PATH] [--players N] [--threads N]
+ *                  [--duration SECONDS] [--words FILE] [--answers FILE] [--strategy FILE] [--hard]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "wordle.h"
+#include "score.h"
+#include "matrix.h"
+#include "wordlist.h"
+#include "strategy.h"
+#include "server.h"
+#include "timing.h"
+
+#define LOADGEN_DEFAULT_PLAYERS 1000
+#define LOADGEN_DEFAULT_THREADS 4
+#define LOADGEN_DEFAULT_DURATION 10
+#define LOADGEN_RAMP_TIMEOUT 60         // seconds to wait for every player to connect
+#define CONNECT_WINDOW 256              // handshakes in flight per thread
+#define PLAYER_INPUT_SIZE 64
+#define EVENT_BATCH 256
+#define LATENCY_SUB_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS (64 * LATENCY_SUB_BUCKETS)
+
+enum {
+    PLAYER_WAITING,             // not connected yet
+    PLAYER_CONNECTING,          // connected or connecting, greeting not seen
+    PLAYER_STARTING,            // sent NEW or HARD
+    PLAYER_GUESSING,            // sent a guess
+    PLAYER_CLOSED
+};
+
+typedef struct {
+    int fd;
+    uint8_t state;
+    uint8_t attempts;
+    uint8_t in_length;
+    uint32_t guesses[MAX_ATTEMPTS];
+    uint8_t patterns[MAX_ATTEMPTS];
+    uint64_t sent_ns;
+    char in[PLAYER_INPUT_SIZE];
+} Player;
+
+typedef struct {
+    struct sockaddr_storage addr;
+    socklen_t length;
+} Target;
+
+typedef struct {
+    Target target;
+    const Strategy *strategy;
+    bool hard;
+    atomic_size_t connected;
+    atomic_size_t failed;
+    atomic_bool measuring;
+    atomic_bool stopping;
+} LoadJob;
+
+// One driver thread and its players. The tallies cover the measured
+// window only.
+typedef struct {
+    LoadJob *job;
+    Player *players;
+    size_t count;
+    size_t next_connect;
+    size_t connecting;
+    int epoll_fd;
+    bool measuring;
+    uint64_t guesses;
+    uint64_t games;
+    uint64_t won;
+    uint64_t won_guesses;
+    uint64_t errors;
+    uint64_t strays;
+    uint64_t dropped;
+    uint64_t latency[LATENCY_BUCKETS];
+    uint64_t max_latency;
+} Driver;
+
+static bool resolve_target(const char *spec, Target *target) {
+    memset(target, 0, sizeof(*target));
+
+    if (strncmp(spec, "unix:", 5) == 0) {
+        struct sockaddr_un *addr = (struct sockaddr_un *)&target->addr;
+        if (strlen(spec + 5) >= sizeof(addr->sun_path)) {
+            fprintf(stderr, "Unix socket path too long: %s\n", spec + 5);
+            return false;
+        }
+        addr->sun_family = AF_UNIX;
+        strcpy(addr->sun_path, spec + 5);
+        target->length = sizeof(*addr);
+        return true;
+    }
+
+    char host[256] = "127.0.0.1";
+    const char *port = spec;
+    const char *colon = strrchr(spec, ':');
+    if (colon != NULL) {
+        snprintf(host, sizeof(host), "%.*s", (int)(colon - spec), spec);
+        port = colon + 1;
+    }
+
+    struct addrinfo hints, *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    int status = getaddrinfo(host, port, &hints, &result);
+    if (status != 0) {
+        fprintf(stderr, "Failed to resolve %s: %s\n", spec, gai_strerror(status));
+        return false;
+    }
+    memcpy(&target->addr, result->ai_addr, result->ai_addrlen);
+    target->length = result->ai_addrlen;
+    freeaddrinfo(result);
+    return true;
+}
+
+static size_t latency_bucket(uint64_t ns) {
+    if (ns < LATENCY_SUB_BUCKETS) {
+        return (size_t)ns;
+    }
+    int msb = 63 - __builtin_clzll(ns);
+    int shift = msb - LATENCY_SUB_BITS;
+    return (size_t)(msb - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS +
+           (size_t)((ns >> shift) & (LATENCY_SUB_BUCKETS - 1));
+}
+
+// Smallest latency that falls in `bucket`
+static uint64_t latency_floor(size_t bucket) {
+    if (bucket < LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+    int shift = (int)(bucket / LATENCY_SUB_BUCKETS) - 1;
+    return (uint64_t)(LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS) << shift;
+}
+
+static void record_latency(Driver *driver, const Player *player) {
+    if (!driver->measuring) {
+        return;
+    }
+    uint64_t ns = monotonic_ns() - player->sent_ns;
+    driver->latency[latency_bucket(ns)]++;
+    if (ns > driver->max_latency) {
+        driver->max_latency = ns;
+    }
+}
+
+static void close_player(Driver *driver, Player *player) {
+    if (player->state == PLAYER_CONNECTING) {
+        driver->connecting--;
+        atomic_fetch_add(&driver->job->failed, 1);
+    } else if (driver->measuring) {
+        driver->dropped++;
+    }
+    close(player->fd);
+    player->fd = -1;
+    player->state = PLAYER_CLOSED;
+}
+
+// Commands are a few bytes and a player has one in flight, so the socket
+// buffer always has room; a short write means the connection is gone
+static bool send_command(Driver *driver, Player *player, const char *text, size_t length, uint8_t state) {
+    player->sent_ns = monotonic_ns();
+    if (write(player->fd, text, length) != (ssize_t)length) {
+        close_player(driver, player);
+        return false;
+    }
+    player->state = state;
+    return true;
+}
+
+static void start_game(Driver *driver, Player *player) {
+    if (driver->job->hard) {
+        send_command(driver, player, "HARD\n", 5, PLAYER_STARTING);
+    } else {
+        send_command(driver, player, "NEW\n", 4, PLAYER_STARTING);
+    }
+}
+
+static void send_guess(Driver *driver, Player *player) {
+    uint32_t guess = strategy_hint(driver->job->strategy, player->guesses, player->patterns, player->attempts);
+    if (guess == STRATEGY_NO_HINT) {
+        driver->strays += driver->measuring;
+        start_game(driver, player);
+        return;
+    }
+
+    char line[WORD_LENGTH + 2];
+    unpack_word(guess, line);
+    line[WORD_LENGTH] = '\n';
+    player->guesses[player->attempts] = guess;
+    send_command(driver, player, line, WORD_LENGTH + 1, PLAYER_GUESSING);
+}
+
+// Reads "<scores> PLAYING|WON|LOST ..."; false for anything else
+static bool parse_reply(const char *line, size_t length, uint8_t *pattern, const char **status) {
+    if (length < WORD_LENGTH + 2 || line[WORD_LENGTH] != ' ') {
+        return false;
+    }
+    int scores[WORD_LENGTH];
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        if (line[i] < '0' || line[i] > '2') {
+            return false;
+        }
+        scores[i] = line[i] - '0';
+    }
+    *pattern = scores_to_pattern(scores);
+    *status = line + WORD_LENGTH + 1;
+    return true;
+}
+
+static void handle_line(Driver *driver, Player *player, const char *line, size_t length) {
+    bool greeting = strncmp(line, "WORDLE ", 7) == 0;
+
+    if (player->state == PLAYER_CONNECTING && greeting) {
+        driver->connecting--;
+        atomic_fetch_add(&driver->job->connected, 1);
+        player->state = PLAYER_STARTING;
+        player->attempts = 0;
+        send_guess(driver, player);
+        return;
+    }
+
+    record_latency(driver, player);
+    uint8_t pattern;
+    const char *status;
+    if (player->state == PLAYER_STARTING && greeting) {
+        player->attempts = 0;
+        send_guess(driver, player);
+    } else if (player->state == PLAYER_GUESSING && parse_reply(line, length, &pattern, &status)) {
+        driver->guesses += driver->measuring;
+        player->patterns[player->attempts++] = pattern;
+        if (strncmp(status, "PLAYING", 7) == 0 && player->attempts < MAX_ATTEMPTS) {
+            send_guess(driver, player);
+            return;
+        }
+        if (driver->measuring) {
+            bool won = strncmp(status, "WON", 3) == 0;
+            driver->games++;
+            driver->won += won;
+            driver->won_guesses += won ? player->attempts : 0;
+        }
+        start_game(driver, player);
+    } else {
+        // ERROR replies, or a reply out of turn
+        driver->errors += driver->measuring;
+        start_game(driver, player);
+    }
+}
+
+static void handle_input(Driver *driver, Player *player) {
+    char buffer[256];
+
+    for (;;) {
+        ssize_t received = read(player->fd, buffer, sizeof(buffer));
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN) {
+                close_player(driver, player);
+            }
+            return;
+        }
+        if (received == 0) {
+            close_player(driver, player);
+            return;
+        }
+
+        for (ssize_t i = 0; i < received && player->state != PLAYER_CLOSED; i++) {
+            if (buffer[i] != '\n') {
+                if (player->in_length + 1 >= PLAYER_INPUT_SIZE) {
+                    close_player(driver, player);
+                    return;
+                }
+                player->in[player->in_length++] = buffer[i];
+                continue;
+            }
+            player->in[player->in_length] = '\0';
+            size_t length = player->in_length;
+            player->in_length = 0;
+            handle_line(driver, player, player->in, length);
+        }
+        if (player->state == PLAYER_CLOSED) {
+            return;
+        }
+    }
+}
+
+// Starts handshakes until CONNECT_WINDOW are in flight; a Unix listener
+// with a full backlog refuses with EAGAIN, so the rest wait for the next
+// round
+static void connect_players(Driver *driver) {
+    const Target *target = &driver->job->target;
+
+    while (driver->connecting < CONNECT_WINDOW && driver->next_connect < driver->count) {
+        Player *player = &driver->players[driver->next_connect];
+        int fd = socket(target->addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            perror("Failed to create socket");
+            atomic_fetch_add(&driver->job->failed, driver->count - driver->next_connect);
+            driver->next_connect = driver->count;
+            return;
+        }
+        if (target->addr.ss_family != AF_UNIX) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        if (connect(fd, (const struct sockaddr *)&target->addr, target->length) != 0 && errno != EINPROGRESS) {
+            close(fd);
+            if (errno == EAGAIN) {
+                return;
+            }
+            perror("Failed to connect");
+            atomic_fetch_add(&driver->job->failed, 1);
+            driver->next_connect++;
+            continue;
+        }
+
+        // The server greets every connection, so readable means connected
+        struct epoll_event event = {EPOLLIN, {.u32 = (uint32_t)driver->next_connect}};
+        epoll_ctl(driver->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        player->fd = fd;
+        player->state = PLAYER_CONNECTING;
+        driver->connecting++;
+        driver->next_connect++;
+    }
+}
+
+static void *driver_run(void *arg) {
+    Driver *driver = arg;
+    struct epoll_event events[EVENT_BATCH];
+
+    driver->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (driver->epoll_fd < 0) {
+        perror("Failed to create epoll instance");
+        atomic_fetch_add(&driver->job->failed, driver->count);
+        return NULL;
+    }
+
+    while (!atomic_load(&driver->job->stopping)) {
+        connect_players(driver);
+        driver->measuring = atomic_load_explicit(&driver->job->measuring, memory_order_relaxed);
+
+        // Wake now and then to see the stop flag and retry refused connects
+        int timeout = driver->next_connect < driver->count ? 10 : 100;
+        int ready = epoll_wait(driver->epoll_fd, events, EVENT_BATCH, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait failed");
+            break;
+        }
+
+        for (int e = 0; e < ready; e++) {
+            Player *player = &driver->players[events[e].data.u32];
+            if (events[e].events & EPOLLIN) {
+                handle_input(driver, player);
+            } else if (player->state != PLAYER_CLOSED) {
+                close_player(driver, player);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < driver->next_connect; i++) {
+        if (driver->players[i].fd >= 0) {
+            close(driver->players[i].fd);
+        }
+    }
+    close(driver->epoll_fd);
+    return NULL;
+}
+
+static void sleep_ms(long ms) {
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR) {
+    }
+}
+
+// Raises the descriptor limit to fit every player, as far as the hard
+// limit allows; returns how many players fit
+static size_t reserve_descriptors(size_t players) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return players;
+    }
+    rlim_t wanted = (rlim_t)players + 64;
+    if (limit.rlim_cur < wanted) {
+        limit.rlim_cur = wanted < limit.rlim_max ? wanted : limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    return limit.rlim_cur >= wanted ? players : (size_t)(limit.rlim_cur > 64 ? limit.rlim_cur - 64 : 0);
+}
+
+static uint64_t latency_percentile(const uint64_t *latency, uint64_t total, double fraction) {
+    uint64_t rank = (uint64_t)(fraction * (double)total);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += latency[b];
+        if (seen > rank) {
+            return latency_floor(b);
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const char *connect_spec = SERVER_DEFAULT_LISTEN;
+    const char *words_file = WORD_LIST_FILE;
+    const char *answers_file = NULL;
+    const char *strategy_path = STRATEGY_FILE;
+    size_t players = LOADGEN_DEFAULT_PLAYERS;
+    int threads = 0;
+    long duration = LOADGEN_DEFAULT_DURATION;
+    bool hard = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--connect") == 0 && i + 1 < argc) {
+            connect_spec = argv[++i];
+        } else if (strcmp(argv[i], "--players") == 0 && i + 1 < argc) {
+            players = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            duration = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            words_file = argv[++i];
+        } else if (strcmp(argv[i], "--answers") == 0 && i + 1 < argc) {
+            answers_file = argv[++i];
+        } else if (strcmp(argv[i], "--strategy") == 0 && i + 1 < argc) {
+            strategy_path = argv[++i];
+        } else if (strcmp(argv[i], "--hard") == 0) {
+            hard = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--connect PORT|HOST:PORT|unix:PATH] [--players N] [--threads N]\n"
+                            "       [--duration SECONDS] [--words FILE] [--answers FILE] [--strategy FILE] [--hard]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The tree is checked against the list it was built for
+    WordList list;
+    bool loaded = answers_file != NULL ? wordlist_load_split(answers_file, words_file, &list)
+                                       : wordlist_load(words_file, &list);
+    if (!loaded) {
+        return EXIT_FAILURE;
+    }
+    Strategy strategy;
+    if (!strategy_load(strategy_path, &list, &strategy)) {
+        fprintf(stderr, "No strategy in %s; build one with wordle --build-strategy%s.\n", strategy_path,
+                hard ? " --hard" : "");
+        wordlist_free(&list);
+        return EXIT_FAILURE;
+    }
+    if (hard && !(strategy.header->flags & STRATEGY_HARD_MODE)) {
+        fprintf(stderr, "%s was built without --hard.\n", strategy_path);
+        strategy_free(&strategy);
+        wordlist_free(&list);
+        return EXIT_FAILURE;
+    }
+
+    size_t usable = reserve_descriptors(players);
+    if (usable < players) {
+        fprintf(stderr, "The descriptor limit allows %zu players; running %zu.\n", usable, usable);
+        players = usable;
+    }
+    if (threads <= 0) {
+        threads = default_thread_count() < LOADGEN_DEFAULT_THREADS ? default_thread_count() : LOADGEN_DEFAULT_THREADS;
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+    if ((size_t)threads > players) {
+        threads = players > 0 ? (int)players : 1;
+    }
+
+    static LoadJob job;
+    if (!resolve_target(connect_spec, &job.target)) {
+        strategy_free(&strategy);
+        wordlist_free(&list);
+        return EXIT_FAILURE;
+    }
+    job.strategy = &strategy;
+    job.hard = hard;
+    atomic_init(&job.connected, 0);
+    atomic_init(&job.failed, 0);
+    atomic_init(&job.measuring, false);
+    atomic_init(&job.stopping, false);
+
+    Player *all = calloc(players > 0 ? players : 1, sizeof(Player));
+    Driver *drivers = calloc((size_t)threads, sizeof(Driver));
+    if (all == NULL || drivers == NULL) {
+        perror("Failed to allocate players");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < players; i++) {
+        all[i].fd = -1;
+    }
+
+    // Contiguous shares, the remainder going to the first drivers
+    size_t offset = 0;
+    for (int t = 0; t < threads; t++) {
+        size_t share = players / threads + ((size_t)t < players % threads);
+        drivers[t].job = &job;
+        drivers[t].players = all + offset;
+        drivers[t].count = share;
+        offset += share;
+    }
+
+    uint64_t ramp_start = monotonic_ns();
+    pthread_t handles[MAX_THREADS];
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&handles[started], NULL, driver_run, &drivers[t]) != 0) {
+            atomic_fetch_add(&job.failed, drivers[t].count);
+            continue;
+        }
+        started++;
+    }
+
+    while (atomic_load(&job.connected) + atomic_load(&job.failed) < players &&
+           elapsed_seconds(ramp_start) < LOADGEN_RAMP_TIMEOUT) {
+        sleep_ms(10);
+    }
+    size_t connected = atomic_load(&job.connected);
+    printf("Connected %zu of %zu players to %s on %d thread%s in %.2f s (%zu failed).\n", connected, players,
+           connect_spec, started, started == 1 ? "" : "s", elapsed_seconds(ramp_start), atomic_load(&job.failed));
+    fflush(stdout);
+
+    uint64_t start = monotonic_ns();
+    atomic_store(&job.measuring, true);
+    sleep_ms(duration * 1000);
+    atomic_store(&job.measuring, false);
+    double seconds = elapsed_seconds(start);
+    atomic_store(&job.stopping, true);
+    for (int t = 0; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+
+    // Merge the per-driver tallies
+    Driver total;
+    memset(&total, 0, sizeof(total));
+    for (int t = 0; t < threads; t++) {
+        total.guesses += drivers[t].guesses;
+        total.games += drivers[t].games;
+        total.won += drivers[t].won;
+        total.won_guesses += drivers[t].won_guesses;
+        total.errors += drivers[t].errors;
+        total.strays += drivers[t].strays;
+        total.dropped += drivers[t].dropped;
+        for (size_t b = 0; b < LATENCY_BUCKETS; b++) {
+            total.latency[b] += drivers[t].latency[b];
+        }
+        if (drivers[t].max_latency > total.max_latency) {
+            total.max_latency = drivers[t].max_latency;
+        }
+    }
+    uint64_t replies = 0;
+    for (size_t b = 0; b < LATENCY_BUCKETS; b++) {
+        replies += total.latency[b];
+    }
+
+    printf("Measured %.2f s: %llu guesses (%.1f guesses/s), %llu replies (%.1f/s)\n", seconds,
+           (unsigned long long)total.guesses, total.guesses / seconds, (unsigned long long)replies,
+           replies / seconds);
+    printf("Games: %llu finished, %.2f%% won, %.4f guesses per win; %llu errors, %llu off the tree, %llu dropped\n",
+           (unsigned long long)total.games, total.games > 0 ? 100.0 * total.won / total.games : 0.0,
+           total.won > 0 ? (double)total.won_guesses / total.won : 0.0, (unsigned long long)total.errors,
+           (unsigned long long)total.strays, (unsigned long long)total.dropped);
+    if (replies > 0) {
+        printf("Latency: p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+               latency_percentile(total.latency, replies, 0.50) / 1e3,
+               latency_percentile(total.latency, replies, 0.90) / 1e3,
+               latency_percentile(total.latency, replies, 0.99) / 1e3,
+               latency_percentile(total.latency, replies, 0.999) / 1e3, total.max_latency / 1e3);
+    }
+
+    free(drivers);
+    free(all);
+    strategy_free(&strategy);
+    wordlist_free(&list);
+    return connected > 0 && replies > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
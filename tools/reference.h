@@ -0,0 +1,40 @@
+// tools/reference.h
+
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include "wordle.h"
+
+// The original nested-loop check_guess, kept verbatim as the baseline the
+// packed, batch and prepared scorers are measured and verified against.
+static inline void reference_check_guess(const char *secret, const char *guess, int *scores) {
+    bool letter_used[WORD_LENGTH] = {false}; // Track used letters in the secret word
+
+    memset(scores, 0, WORD_LENGTH * sizeof(int));
+
+    // First pass: Check for correct positions
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        if (tolower(guess[i]) == tolower(secret[i])) {
+            scores[i] = CORRECT_LETTER_CORRECT_POSITION;
+            letter_used[i] = true;
+        }
+    }
+
+    // Second pass: Check for correct letters in wrong positions
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        if (scores[i] != CORRECT_LETTER_CORRECT_POSITION) {
+            for (int j = 0; j < WORD_LENGTH; j++) {
+                if (!letter_used[j] && tolower(guess[i]) == tolower(secret[j])) {
+                    scores[i] = CORRECT_LETTER_WRONG_POSITION;
+                    letter_used[j] = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+#endif
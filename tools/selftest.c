@@ -0,0 +1,343 @@
+/*
+ * File: tools/selftest.c
+ * Description: Checks of edge cases the other tools do not reach.
+ *
+ *   Each check runs a piece of the game on a small input built here and
+ *   compares it with the answer worked out independently, so a regression
+ *   shows up as a FAIL line naming the case. The exit status is nonzero if
+ *   any check fails.
+ *
+ *   - score_stream with blocks smaller than some of its lines: an overlong
+ *     line must score as exactly one invalid pair, wherever it falls.
+ *   - daily_parse_date against dates each month does and does not have,
+ *     leap days included.
+ *   - choose_random_word_from on a list split into answers and guesses:
+ *     every secret must come from the answers.
+ *   - the hard-mode Constraints over random games on the word list: after
+ *     each guess constraints_admits must accept exactly the words that
+ *     score like the secret against every guess so far, and each of them
+ *     must be a legal hard-mode guess.
+ *   - dictionaries and game logs whose header was written on a machine of
+ *     the other byte order must be refused, not misread.
+ *   - metrics_observe at and around powers of two: a sample of exactly
+ *     2^k ns must land in the bucket exported as le="2^k".
+ *
+ * Usage:
+ *   wordle-selftest [--words FILE]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "wordle.h"
+#include "score.h"
+#include "stream.h"
+#include "daily.h"
+#include "wordlist.h"
+#include "metrics.h"
+#include "constraints.h"
+#include "rng.h"
+#include "dict.h"
+#include "gamelog.h"
+#include "reference.h"
+
+#define SELFTEST_BLOCK_SIZE 32
+#define SELFTEST_MAX_OUTPUT 4096
+#define SELFTEST_DRAWS 10000
+#define SELFTEST_HARD_GAMES 200
+
+static int checks = 0;
+static int failures = 0;
+
+static void check(bool ok, const char *name) {
+    checks++;
+    if (!ok) {
+        failures++;
+        printf("FAIL %s\n", name);
+    }
+}
+
+// The text line score_stream should print for one pair
+static void expected_line(const char *secret, const char *guess, char *line) {
+    int scores[WORD_LENGTH];
+    reference_check_guess(secret, guess, scores);
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        line[i] = (char)('0' + scores[i]);
+    }
+    line[WORD_LENGTH] = '\n';
+    line[WORD_LENGTH + 1] = '\0';
+}
+
+// Runs score_stream over input with small blocks and returns its text output
+static bool run_stream(const char *input, char *output, StreamStats *stats) {
+    FILE *in = tmpfile();
+    FILE *out = tmpfile();
+    if (in == NULL || out == NULL) {
+        perror("Failed to create a temporary file");
+        exit(EXIT_FAILURE);
+    }
+    fputs(input, in);
+    fflush(in);
+    rewind(in);
+
+    StreamOptions options = {STREAM_TEXT, SELFTEST_BLOCK_SIZE};
+    bool ok = score_stream(fileno(in), fileno(out), &options, stats) == EXIT_SUCCESS;
+
+    rewind(out);
+    size_t length = fread(output, 1, SELFTEST_MAX_OUTPUT - 1, out);
+    output[length] = '\0';
+    fclose(in);
+    fclose(out);
+    return ok;
+}
+
+static void check_stream_overlong_lines(void) {
+    char slate[WORD_LENGTH + 2], world[WORD_LENGTH + 2];
+    expected_line("crane", "slate", slate);
+    expected_line("hello", "world", world);
+
+    // One block's worth, several blocks' worth, and a long line that ends
+    // the input without a newline
+    char longest[8 * SELFTEST_BLOCK_SIZE + 1];
+    memset(longest, 'x', sizeof(longest) - 1);
+    longest[sizeof(longest) - 1] = '\0';
+    const size_t lengths[] = {SELFTEST_BLOCK_SIZE, SELFTEST_BLOCK_SIZE + 1, 3 * SELFTEST_BLOCK_SIZE - 7,
+                              sizeof(longest) - 1};
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        char input[SELFTEST_MAX_OUTPUT], expected[SELFTEST_MAX_OUTPUT], output[SELFTEST_MAX_OUTPUT];
+        StreamStats stats;
+        char name[96];
+
+        snprintf(input, sizeof(input), "crane slate\n%.*s\nhello world\n", (int)lengths[i], longest);
+        snprintf(expected, sizeof(expected), "%s-----\n%s", slate, world);
+        snprintf(name, sizeof(name), "score_stream: %zu-byte line between two pairs", lengths[i]);
+        check(run_stream(input, output, &stats) && strcmp(output, expected) == 0 && stats.pairs == 3 &&
+                  stats.invalid == 1,
+              name);
+
+        snprintf(input, sizeof(input), "crane slate\n%.*s", (int)lengths[i], longest);
+        snprintf(expected, sizeof(expected), "%s-----\n", slate);
+        snprintf(name, sizeof(name), "score_stream: %zu-byte last line without a newline", lengths[i]);
+        check(run_stream(input, output, &stats) && strcmp(output, expected) == 0 && stats.pairs == 2 &&
+                  stats.invalid == 1,
+              name);
+    }
+}
+
+static void check_daily_dates(void) {
+    static const char *const valid[] = {"1970-01-01", "2021-06-19", "2023-04-30", "2023-12-31",
+                                        "2024-02-29", "2000-02-29"};
+    static const char *const invalid[] = {"2024-02-31", "2023-04-31", "2023-02-29", "1900-02-29", "2023-06-31",
+                                          "2023-11-31", "2023-01-32", "2023-01-00", "2023-00-10", "2023-13-01",
+                                          "2023-01-01x", "20230101"};
+    int64_t day;
+    char name[96];
+
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        snprintf(name, sizeof(name), "daily_parse_date accepts %s", valid[i]);
+        check(daily_parse_date(valid[i], &day), name);
+    }
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        snprintf(name, sizeof(name), "daily_parse_date rejects %s", invalid[i]);
+        check(!daily_parse_date(invalid[i], &day), name);
+    }
+
+    int64_t leap_day, next;
+    check(daily_parse_date("1970-01-01", &day) && day == 0, "daily_parse_date: 1970-01-01 is day 0");
+    check(daily_parse_date("2024-02-29", &leap_day) && daily_parse_date("2024-03-01", &next) &&
+              next == leap_day + 1,
+          "daily_parse_date: 2024-03-01 follows 2024-02-29");
+}
+
+// Writes lines to a new temporary file and stores its name in path
+static void write_temp_list(const char *lines, char *path) {
+    strcpy(path, "/tmp/wordle-selftest-XXXXXX");
+    int fd = mkstemp(path);
+    if (fd < 0 || write(fd, lines, strlen(lines)) != (ssize_t)strlen(lines)) {
+        perror("Failed to write a temporary word list");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+}
+
+static void check_secrets_from_answers(void) {
+    // A few answers among many more guesses, so a draw over the whole list
+    // lands outside the answers almost every time
+    static const char *const answers[] = {"crane", "slate", "tears"};
+    const size_t answer_count = sizeof(answers) / sizeof(answers[0]);
+    char answers_path[32], guesses_path[32];
+
+    write_temp_list("crane\nslate\ntears\n", answers_path);
+    write_temp_list("abbey\nabide\nbloke\ncrane\ndecoy\nevery\nfight\ngeese\nhello\nirony\njoker\n"
+                    "knelt\nlemon\nmoist\nnerve\noxide\nplumb\nquart\nrouge\nspeed\nthump\nunzip\n"
+                    "vapid\nwaltz\nxenon\nyacht\nzesty\n",
+                    guesses_path);
+
+    WordList list;
+    bool loaded = wordlist_load_split(answers_path, guesses_path, &list);
+    unlink(answers_path);
+    unlink(guesses_path);
+    check(loaded && list.answer_count == answer_count && list.count > answer_count,
+          "wordlist_load_split keeps the answers as a prefix");
+    if (!loaded) {
+        return;
+    }
+
+    size_t outside = 0;
+    for (int draw = 0; draw < SELFTEST_DRAWS; draw++) {
+        char word[WORD_LENGTH + 1];
+        choose_random_word_from(&list, word);
+
+        bool found = false;
+        for (size_t a = 0; a < answer_count; a++) {
+            found = found || strcmp(word, answers[a]) == 0;
+        }
+        outside += !found;
+    }
+    check(outside == 0, "choose_random_word_from draws only answers from a split list");
+    wordlist_free(&list);
+}
+
+static void check_hard_mode_constraints(const char *words_file) {
+    WordList list;
+    if (!wordlist_load(words_file, &list)) {
+        check(false, "constraints: the word list loads");
+        return;
+    }
+
+    Rng rng;
+    size_t admit_mismatches = 0, refused_guesses = 0;
+    rng_seed(&rng, 1);
+    for (int game = 0; game < SELFTEST_HARD_GAMES; game++) {
+        uint32_t secret = list.packed[rng_bounded(&rng, list.answer_count)];
+        uint32_t guesses[MAX_ATTEMPTS];
+        uint8_t patterns[MAX_ATTEMPTS];
+        Constraints constraints;
+
+        constraints_init(&constraints);
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+            guesses[attempt] = list.packed[rng_bounded(&rng, list.count)];
+            patterns[attempt] = score_packed(secret, guesses[attempt]);
+            constraints_update(&constraints, guesses[attempt], patterns[attempt]);
+
+            // The slow answer: a word is still possible when it would have
+            // produced every pattern seen so far
+            for (size_t w = 0; w < list.count; w++) {
+                bool consistent = true;
+                for (int g = 0; g <= attempt && consistent; g++) {
+                    consistent = score_packed(list.packed[w], guesses[g]) == patterns[g];
+                }
+                bool admitted = constraints_admits(&constraints, list.packed[w]);
+                admit_mismatches += admitted != consistent;
+                refused_guesses += admitted && !constraints_allows_guess(&constraints, list.packed[w]);
+            }
+        }
+    }
+
+    check(admit_mismatches == 0, "constraints_admits accepts exactly the words consistent with the feedback");
+    check(refused_guesses == 0, "constraints_allows_guess accepts every word constraints_admits does");
+    wordlist_free(&list);
+}
+
+// Overwrites `size` bytes of the file at `offset`
+static void patch_file(const char *path, off_t offset, const void *data, size_t size) {
+    int fd = open(path, O_WRONLY);
+    if (fd < 0 || pwrite(fd, data, size, offset) != (ssize_t)size) {
+        perror("Failed to patch a temporary file");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+}
+
+static void check_foreign_byte_order(void) {
+    char path[32];
+    DictView view;
+    GameLog log;
+    GameLogView log_view;
+    const uint32_t words[] = {pack_word("crane"), pack_word("slate"), pack_word("tears")};
+
+    write_temp_list("", path);
+    bool written = dict_write(path, words, sizeof(words) / sizeof(words[0]), DICT_HAS_LETTER_FREQ, NULL);
+    bool mapped = written && dict_map(path, &view);
+    check(mapped, "dict_map accepts a dictionary of this byte order");
+    if (mapped) {
+        dict_unmap(&view);
+    }
+    uint16_t dict_version = DICT_VERSION_SWAPPED;
+    patch_file(path, offsetof(DictHeader, version), &dict_version, sizeof(dict_version));
+    check(written && !dict_map(path, &view), "dict_map refuses a dictionary of the other byte order");
+    unlink(path);
+
+    write_temp_list("", path);
+    bool opened = gamelog_open(path, &log);
+    if (opened) {
+        gamelog_close(&log);
+    }
+    mapped = opened && gamelog_map(path, &log_view);
+    check(mapped, "gamelog_map accepts a log of this byte order");
+    if (mapped) {
+        gamelog_unmap(&log_view);
+    }
+    uint32_t log_version = GAMELOG_VERSION_SWAPPED;
+    patch_file(path, offsetof(GameLogHeader, version), &log_version, sizeof(log_version));
+    check(opened && !gamelog_map(path, &log_view), "gamelog_map refuses a log of the other byte order");
+    check(opened && !gamelog_open(path, &log), "gamelog_open refuses a log of the other byte order");
+    unlink(path);
+}
+
+// The bucket one observation landed in, or -1
+static int observed_bucket(uint64_t ns) {
+    MetricsShard *shard = metrics_shard();
+    uint64_t before[METRICS_BUCKETS];
+    for (int b = 0; b < METRICS_BUCKETS; b++) {
+        before[b] = shard->buckets[HISTOGRAM_DICT_LOAD][b];
+    }
+    metrics_observe(HISTOGRAM_DICT_LOAD, ns);
+    for (int b = 0; b < METRICS_BUCKETS; b++) {
+        if (shard->buckets[HISTOGRAM_DICT_LOAD][b] != before[b]) {
+            return b;
+        }
+    }
+    return -1;
+}
+
+static void check_metrics_buckets(void) {
+    char name[96];
+
+    check(observed_bucket(0) == 0 && observed_bucket(1) == 0, "metrics_observe: 0 and 1 ns are le=\"1\"");
+    for (int k = 1; k < METRICS_BUCKETS - 1; k++) {
+        uint64_t power = UINT64_C(1) << k;
+        snprintf(name, sizeof(name), "metrics_observe: 2^%d ns is le=2^%d, one more is le=2^%d", k, k, k + 1);
+        check(observed_bucket(power) == k && observed_bucket(power + 1) == k + 1 &&
+                  observed_bucket(power - 1) == (k == 1 ? 0 : k),
+              name);
+    }
+    check(observed_bucket(UINT64_MAX) == METRICS_BUCKETS - 1, "metrics_observe: the last bucket takes the rest");
+}
+
+int main(int argc, char **argv) {
+    const char *words_file = WORD_LIST_FILE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            words_file = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--words FILE]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    check_stream_overlong_lines();
+    check_daily_dates();
+    check_secrets_from_answers();
+    check_hard_mode_constraints(words_file);
+    check_foreign_byte_order();
+    check_metrics_buckets();
+
+    printf("%d checks, %d failed.\n", checks, failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
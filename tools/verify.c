@@ -0,0 +1,372 @@
+/*
+ * File: tools/verify.c
+ * Description: Differential check of every scorer against the original
+ *   check_guess (tools/reference.h).
+ *
+ *   Each work item is a block of (secret, guess) pairs laid out guess-major:
+ *   one row of the word list (a guess against every secret), or a block of
+ *   random words drawn from a small alphabet in mixed case, so that repeated
+ *   letters ("speed" against "abide", "eerie" against "geese") come up
+ *   constantly. The reference patterns are computed once per block and every
+ *   scorer in the table below is run over the same block: check_guess,
+ *   score_packed, score_prepared, score_pairs (dispatched and scalar) and
+ *   each batch kernel the CPU supports, by name.
+ *
+ *   Every other random block also draws digits and punctuation, which the
+ *   reference compares byte for byte. Packing folds all of them into one
+ *   invalid letter, so those blocks check check_guess alone.
+ *
+ *   Workers claim blocks from a shared counter, like matrix_build, and the
+ *   random blocks are seeded from their index, so the pairs checked do not
+ *   depend on the thread count. Any disagreement is printed with the scorer,
+ *   the pair and both patterns, and the exit status is nonzero.
+ *
+ * Usage:
+ *   wordle-verify [--words FILE] [--fuzz N] [--seed N] [--threads N]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "wordle.h"
+#include "score.h"
+#include "wordlist.h"
+#include "matrix.h"
+#include "rng.h"
+#include "timing.h"
+#include "reference.h"
+
+#define VERIFY_MAX_REPORTS 20
+#define VERIFY_MAX_SCORERS 16
+
+// A random block is FUZZ_GUESSES guesses against FUZZ_SECRETS secrets. An
+// odd secret count runs the vector kernels through their scalar tails and
+// puts two different guesses in the same score_pairs vector at every row
+// boundary.
+#define FUZZ_GUESSES 8
+#define FUZZ_SECRETS 61
+#define FUZZ_BLOCK (FUZZ_GUESSES * FUZZ_SECRETS)
+
+typedef char VerifyWord[WORD_LENGTH + 1];
+
+// n pairs, as the text the reference and check_guess take and as the
+// packed words the other scorers take
+typedef struct {
+    size_t n;
+    const VerifyWord *secret_text;
+    const VerifyWord *guess_text;
+    const uint32_t *secrets;
+    const uint32_t *guesses;
+    bool letters_only;          // false when the packed words cannot stand in for the text
+} VerifyBlock;
+
+typedef void (*verify_score_fn)(const VerifyBlock *block, const BatchScorer *batch, uint8_t *out);
+
+typedef struct {
+    char name[48];
+    verify_score_fn score;
+    const BatchScorer *batch;
+    bool packed;                // scores the packed words; skipped on mixed blocks
+    atomic_size_t pairs;
+    atomic_size_t mismatches;
+} VerifyScorer;
+
+static void verify_check_guess(const VerifyBlock *block, const BatchScorer *batch, uint8_t *out) {
+    int scores[WORD_LENGTH];
+    (void)batch;
+    for (size_t i = 0; i < block->n; i++) {
+        check_guess(block->secret_text[i], block->guess_text[i], scores);
+        out[i] = scores_to_pattern(scores);
+    }
+}
+
+static void verify_score_packed(const VerifyBlock *block, const BatchScorer *batch, uint8_t *out) {
+    (void)batch;
+    for (size_t i = 0; i < block->n; i++) {
+        out[i] = score_packed(block->secrets[i], block->guesses[i]);
+    }
+}
+
+static void verify_score_prepared(const VerifyBlock *block, const BatchScorer *batch, uint8_t *out) {
+    PreparedSecret prepared;
+    (void)batch;
+    for (size_t i = 0; i < block->n; i++) {
+        prepare_secret(block->secrets[i], &prepared);
+        out[i] = score_prepared(&prepared, block->guesses[i]);
+    }
+}
+
+static void verify_score_pairs(const VerifyBlock *block, const BatchScorer *batch, uint8_t *out) {
+    (void)batch;
+    score_pairs(block->secrets, block->guesses, block->n, out);
+}
+
+static void verify_score_pairs_scalar(const VerifyBlock *block, const BatchScorer *batch, uint8_t *out) {
+    (void)batch;
+    score_pairs_scalar(block->secrets, block->guesses, block->n, out);
+}
+
+// Batch kernels score one guess against many secrets, so each run of pairs
+// sharing a guess is one call
+static void verify_batch(const VerifyBlock *block, const BatchScorer *batch, uint8_t *out) {
+    size_t first = 0;
+    while (first < block->n) {
+        size_t last = first + 1;
+        while (last < block->n && block->guesses[last] == block->guesses[first]) {
+            last++;
+        }
+        batch->score(block->guesses[first], block->secrets + first, last - first, out + first);
+        first = last;
+    }
+}
+
+typedef struct {
+    VerifyScorer scorers[VERIFY_MAX_SCORERS];
+    size_t scorer_count;
+    const WordList *list;
+    const VerifyWord *list_text;
+    size_t fuzz_blocks;
+    uint64_t seed;
+    atomic_size_t next_item;
+    atomic_size_t reports;
+    pthread_mutex_t report_lock;
+} VerifyJob;
+
+static void add_scorer(VerifyJob *job, const char *name, verify_score_fn score, const BatchScorer *batch,
+                       bool packed) {
+    VerifyScorer *scorer = &job->scorers[job->scorer_count++];
+    snprintf(scorer->name, sizeof(scorer->name), "%s", name);
+    scorer->score = score;
+    scorer->batch = batch;
+    scorer->packed = packed;
+    atomic_init(&scorer->pairs, 0);
+    atomic_init(&scorer->mismatches, 0);
+}
+
+static void report_mismatch(VerifyJob *job, VerifyScorer *scorer, const VerifyBlock *block, size_t i,
+                            uint8_t expected, uint8_t actual) {
+    atomic_fetch_add(&scorer->mismatches, 1);
+    if (atomic_fetch_add(&job->reports, 1) >= VERIFY_MAX_REPORTS) {
+        return;
+    }
+
+    int want[WORD_LENGTH], got[WORD_LENGTH];
+    pattern_to_scores(expected, want);
+    pattern_to_scores(actual, got);
+    pthread_mutex_lock(&job->report_lock);
+    printf("MISMATCH %s secret=%s guess=%s expected=%d%d%d%d%d got=%d%d%d%d%d\n", scorer->name,
+           block->secret_text[i], block->guess_text[i], want[0], want[1], want[2], want[3], want[4], got[0],
+           got[1], got[2], got[3], got[4]);
+    pthread_mutex_unlock(&job->report_lock);
+}
+
+static void check_block(VerifyJob *job, const VerifyBlock *block, uint8_t *expected, uint8_t *actual) {
+    int scores[WORD_LENGTH];
+
+    for (size_t i = 0; i < block->n; i++) {
+        reference_check_guess(block->secret_text[i], block->guess_text[i], scores);
+        expected[i] = scores_to_pattern(scores);
+    }
+
+    for (size_t s = 0; s < job->scorer_count; s++) {
+        VerifyScorer *scorer = &job->scorers[s];
+        if (scorer->packed && !block->letters_only) {
+            continue;
+        }
+        scorer->score(block, scorer->batch, actual);
+        atomic_fetch_add(&scorer->pairs, block->n);
+        for (size_t i = 0; i < block->n; i++) {
+            if (actual[i] != expected[i]) {
+                report_mismatch(job, scorer, block, i, expected[i], actual[i]);
+            }
+        }
+    }
+}
+
+// Six letters per slot keep duplicates common. The symbols include the
+// neighbours of 'A', 'Z', 'a' and 'z', which a case fold done by bit
+// twiddling would mistake for letters.
+static const char letter_alphabet[] = "eaoszk";
+static const char mixed_alphabet[] = "eaoszk09@[`{-'";
+
+static void random_word(Rng *rng, const char *alphabet, size_t size, char *word) {
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        char c = alphabet[rng_bounded(rng, size)];
+        // The case bit exercises the reference's tolower against the
+        // packer's case folding
+        word[i] = (c >= 'a' && c <= 'z' && (rng_next(rng) & 1)) ? (char)(c - 'a' + 'A') : c;
+    }
+    word[WORD_LENGTH] = '\0';
+}
+
+// Returns whether the block is letters only
+static bool fill_fuzz_block(uint64_t seed, size_t index, VerifyWord *secret_text, VerifyWord *guess_text,
+                            uint32_t *secrets, uint32_t *guesses) {
+    Rng rng;
+    VerifyWord row_secrets[FUZZ_SECRETS];
+    bool letters_only = index % 2 == 0;
+    const char *alphabet = letters_only ? letter_alphabet : mixed_alphabet;
+    size_t size = letters_only ? sizeof(letter_alphabet) - 1 : sizeof(mixed_alphabet) - 1;
+
+    rng_seed(&rng, seed ^ (index * 0x9e3779b97f4a7c15ULL));
+    for (size_t s = 0; s < FUZZ_SECRETS; s++) {
+        random_word(&rng, alphabet, size, row_secrets[s]);
+    }
+    for (size_t g = 0; g < FUZZ_GUESSES; g++) {
+        VerifyWord guess;
+        random_word(&rng, alphabet, size, guess);
+        for (size_t s = 0; s < FUZZ_SECRETS; s++) {
+            size_t i = g * FUZZ_SECRETS + s;
+            memcpy(secret_text[i], row_secrets[s], sizeof(VerifyWord));
+            memcpy(guess_text[i], guess, sizeof(VerifyWord));
+            secrets[i] = pack_word(secret_text[i]);
+            guesses[i] = pack_word(guess_text[i]);
+        }
+    }
+    return letters_only;
+}
+
+static void *verify_worker(void *arg) {
+    VerifyJob *job = arg;
+    size_t count = job->list->count;
+    size_t capacity = count > FUZZ_BLOCK ? count : FUZZ_BLOCK;
+    VerifyWord *guess_text = malloc(capacity * sizeof(VerifyWord));
+    VerifyWord *secret_text = malloc(FUZZ_BLOCK * sizeof(VerifyWord));
+    uint32_t *guesses = malloc(capacity * sizeof(uint32_t));
+    uint32_t *secrets = malloc(FUZZ_BLOCK * sizeof(uint32_t));
+    uint8_t *expected = malloc(capacity);
+    uint8_t *actual = malloc(capacity);
+    if (guess_text == NULL || secret_text == NULL || guesses == NULL || secrets == NULL || expected == NULL ||
+        actual == NULL) {
+        perror("Failed to allocate verify buffers");
+        exit(EXIT_FAILURE);
+    }
+
+    // Items [0, count) are word-list rows, the rest are random blocks
+    for (;;) {
+        size_t item = atomic_fetch_add(&job->next_item, 1);
+        VerifyBlock block;
+
+        if (item < count) {
+            for (size_t s = 0; s < count; s++) {
+                memcpy(guess_text[s], job->list_text[item], sizeof(VerifyWord));
+                guesses[s] = job->list->packed[item];
+            }
+            block = (VerifyBlock){count, job->list_text, guess_text, job->list->packed, guesses, true};
+        } else if (item - count < job->fuzz_blocks) {
+            bool letters_only = fill_fuzz_block(job->seed, item - count, secret_text, guess_text, secrets, guesses);
+            block = (VerifyBlock){FUZZ_BLOCK, secret_text, guess_text, secrets, guesses, letters_only};
+        } else {
+            break;
+        }
+        check_block(job, &block, expected, actual);
+    }
+
+    free(guess_text);
+    free(secret_text);
+    free(guesses);
+    free(secrets);
+    free(expected);
+    free(actual);
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    const char *words_file = WORD_LIST_FILE;
+    size_t fuzz = 1000000;
+    uint64_t seed = 1;
+    int threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--words") == 0 && i + 1 < argc) {
+            words_file = argv[++i];
+        } else if (strcmp(argv[i], "--fuzz") == 0 && i + 1 < argc) {
+            fuzz = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--words FILE] [--fuzz N] [--seed N] [--threads N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    WordList list;
+    if (!wordlist_load(words_file, &list)) {
+        return EXIT_FAILURE;
+    }
+
+    VerifyWord *list_text = malloc((list.count > 0 ? list.count : 1) * sizeof(VerifyWord));
+    if (list_text == NULL) {
+        perror("Failed to allocate word list text");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < list.count; i++) {
+        unpack_word(list.packed[i], list_text[i]);
+    }
+
+    static VerifyJob job;
+    job.list = &list;
+    job.list_text = list_text;
+    job.fuzz_blocks = (fuzz + FUZZ_BLOCK - 1) / FUZZ_BLOCK;
+    job.seed = seed;
+    atomic_init(&job.next_item, 0);
+    atomic_init(&job.reports, 0);
+    pthread_mutex_init(&job.report_lock, NULL);
+
+    add_scorer(&job, "check_guess", verify_check_guess, NULL, false);
+    add_scorer(&job, "score_packed", verify_score_packed, NULL, true);
+    add_scorer(&job, "score_prepared", verify_score_prepared, NULL, true);
+    add_scorer(&job, "score_pairs", verify_score_pairs, NULL, true);
+    add_scorer(&job, "score_pairs_scalar", verify_score_pairs_scalar, NULL, true);
+
+    const BatchScorer *batch;
+    size_t batch_count = batch_scorers(&batch);
+    for (size_t i = 0; i < batch_count && job.scorer_count < VERIFY_MAX_SCORERS; i++) {
+        char name[48];
+        snprintf(name, sizeof(name), "check_guess_batch/%s", batch[i].name);
+        add_scorer(&job, name, verify_batch, &batch[i], true);
+    }
+
+    if (threads <= 0) {
+        threads = default_thread_count();
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    uint64_t start = monotonic_ns();
+    pthread_t workers[MAX_THREADS];
+    int started = 0;
+    // The calling thread is the first worker
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&workers[started], NULL, verify_worker, &job) != 0) {
+            break;
+        }
+        started++;
+    }
+    verify_worker(&job);
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    double seconds = elapsed_seconds(start);
+
+    size_t total = 0;
+    for (size_t s = 0; s < job.scorer_count; s++) {
+        size_t pairs = atomic_load(&job.scorers[s].pairs);
+        size_t mismatches = atomic_load(&job.scorers[s].mismatches);
+        printf("%-28s %12zu pairs %10zu mismatches\n", job.scorers[s].name, pairs, mismatches);
+        total += mismatches;
+    }
+    printf("Checked %zu list pairs and %zu random pairs against %zu scorers on %d threads in %.2f s: "
+           "%zu mismatches.\n",
+           list.count * list.count, job.fuzz_blocks * FUZZ_BLOCK, job.scorer_count, started + 1, seconds, total);
+
+    free(list_text);
+    wordlist_free(&list);
+    return total == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,384 @@
+/*
+ * File: tools/wordle_logq.c
+ * Description: Aggregate queries over a binary game log (see gamelog.c).
+ *
+ *   The log is mapped read-only and its records are scanned in chunks that
+ *   worker threads claim from a shared counter. Each worker keeps its own
+ *   tallies: the guess-count distribution, and per-word statistics for
+ *   every secret and every opener in small open-addressing tables keyed by
+ *   the packed word. The tables are merged once the scan is done, so a
+ *   record costs a few loads and two table probes and no lock.
+ *
+ *   A secret's difficulty is its average guess count with a loss scored as
+ *   MAX_ATTEMPTS + 1, so a secret that is sometimes missed ranks above one
+ *   that is always found on the last guess.
+ *
+ * Usage:
+ *   wordle-logq LOG [--source interactive|server|simulated] [--hard] [--daily]
+ *               [--top K] [--min-games N] [--threads N]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "wordle.h"
+#include "score.h"
+#include "matrix.h"
+#include "gamelog.h"
+#include "timing.h"
+
+#define SCAN_CHUNK 65536
+#define TABLE_MIN_CAPACITY 1024
+#define WORD_NONE UINT32_MAX
+#define SOURCE_ANY UINT32_MAX
+
+static const char *const source_names[] = {"interactive", "server", "simulated"};
+
+typedef struct {
+    uint32_t word;              // packed, WORD_NONE for an empty slot
+    uint32_t games;
+    uint32_t won;
+    uint64_t score;             // guesses, a loss counting MAX_ATTEMPTS + 1
+} WordStats;
+
+// Open addressing with linear probing; capacity is a power of two and the
+// table is kept at most half full
+typedef struct {
+    WordStats *slots;
+    size_t capacity;
+    size_t used;
+} WordTable;
+
+typedef struct {
+    const GameLogView *view;
+    uint32_t source;            // SOURCE_ANY or a GAMELOG_* source
+    unsigned int required;      // flags every counted record must carry
+    size_t chunk_count;
+    atomic_size_t next;
+} QueryJob;
+
+typedef struct {
+    QueryJob *job;
+    size_t games;
+    size_t corrupt;
+    size_t by_source[GAMELOG_SOURCE_MASK + 1];
+    size_t hard;
+    size_t daily;
+    // solved_in[k] counts games won on guess k + 1
+    size_t solved_in[MAX_ATTEMPTS];
+    size_t failures;
+    WordTable secrets;
+    WordTable openers;
+} QueryWorker;
+
+static void table_init(WordTable *table, size_t capacity) {
+    table->slots = malloc(capacity * sizeof(WordStats));
+    if (table->slots == NULL) {
+        perror("Failed to allocate word table");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        table->slots[i].word = WORD_NONE;
+    }
+    table->capacity = capacity;
+    table->used = 0;
+}
+
+static void table_free(WordTable *table) {
+    free(table->slots);
+    memset(table, 0, sizeof(*table));
+}
+
+static WordStats *table_slot(WordStats *slots, size_t capacity, uint32_t word) {
+    size_t mask = capacity - 1;
+    size_t i = (size_t)(word * 2654435761u) & mask;
+    while (slots[i].word != WORD_NONE && slots[i].word != word) {
+        i = (i + 1) & mask;
+    }
+    return &slots[i];
+}
+
+static void table_grow(WordTable *table) {
+    WordTable grown;
+    table_init(&grown, table->capacity * 2);
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->slots[i].word != WORD_NONE) {
+            *table_slot(grown.slots, grown.capacity, table->slots[i].word) = table->slots[i];
+        }
+    }
+    grown.used = table->used;
+    table_free(table);
+    *table = grown;
+}
+
+static WordStats *table_find_or_add(WordTable *table, uint32_t word) {
+    WordStats *slot = table_slot(table->slots, table->capacity, word);
+    if (slot->word == WORD_NONE) {
+        if ((table->used + 1) * 2 > table->capacity) {
+            table_grow(table);
+            slot = table_slot(table->slots, table->capacity, word);
+        }
+        *slot = (WordStats){word, 0, 0, 0};
+        table->used++;
+    }
+    return slot;
+}
+
+static void table_count(WordTable *table, uint32_t word, bool won, unsigned int score) {
+    WordStats *stats = table_find_or_add(table, word);
+    stats->games++;
+    stats->won += won;
+    stats->score += score;
+}
+
+static void table_merge(WordTable *into, const WordTable *from) {
+    for (size_t i = 0; i < from->capacity; i++) {
+        const WordStats *stats = &from->slots[i];
+        if (stats->word != WORD_NONE) {
+            WordStats *total = table_find_or_add(into, stats->word);
+            total->games += stats->games;
+            total->won += stats->won;
+            total->score += stats->score;
+        }
+    }
+}
+
+static void scan_record(QueryWorker *worker, const GameRecord *record) {
+    QueryJob *job = worker->job;
+    unsigned int source = record->flags & GAMELOG_SOURCE_MASK;
+    if ((job->source != SOURCE_ANY && source != job->source) || (record->flags & job->required) != job->required) {
+        return;
+    }
+    if (record->attempts == 0 || record->attempts > MAX_ATTEMPTS) {
+        worker->corrupt++;
+        return;
+    }
+
+    bool won = (record->flags & GAMELOG_WON) != 0;
+    unsigned int score = won ? record->attempts : MAX_ATTEMPTS + 1;
+    worker->games++;
+    worker->by_source[source]++;
+    worker->hard += (record->flags & GAMELOG_HARD) != 0;
+    worker->daily += (record->flags & GAMELOG_DAILY) != 0;
+    if (won) {
+        worker->solved_in[record->attempts - 1]++;
+    } else {
+        worker->failures++;
+    }
+    table_count(&worker->secrets, record->secret, won, score);
+    table_count(&worker->openers, record->guesses[0], won, score);
+}
+
+static void *query_worker(void *arg) {
+    QueryWorker *worker = arg;
+    QueryJob *job = worker->job;
+
+    for (;;) {
+        size_t chunk = atomic_fetch_add(&job->next, 1);
+        if (chunk >= job->chunk_count) {
+            break;
+        }
+
+        size_t begin = chunk * SCAN_CHUNK;
+        size_t end = begin + SCAN_CHUNK < job->view->count ? begin + SCAN_CHUNK : job->view->count;
+        for (size_t i = begin; i < end; i++) {
+            scan_record(worker, &job->view->records[i]);
+        }
+    }
+
+    return NULL;
+}
+
+static double difficulty(const WordStats *stats) {
+    return (double)stats->score / stats->games;
+}
+
+// Hardest first; ties go to the more played word
+static int compare_hardest(const void *a, const void *b) {
+    const WordStats *x = a;
+    const WordStats *y = b;
+    double dx = difficulty(x);
+    double dy = difficulty(y);
+    if (dx != dy) {
+        return dx < dy ? 1 : -1;
+    }
+    if (x->games != y->games) {
+        return x->games < y->games ? 1 : -1;
+    }
+    return x->word < y->word ? -1 : x->word > y->word;
+}
+
+static int compare_most_played(const void *a, const void *b) {
+    const WordStats *x = a;
+    const WordStats *y = b;
+    if (x->games != y->games) {
+        return x->games < y->games ? 1 : -1;
+    }
+    return x->word < y->word ? -1 : x->word > y->word;
+}
+
+// Prints the first `top` words of `table` in `compare` order that were
+// seen in at least `min_games` games
+static void print_words(const char *title, const WordTable *table, size_t top, size_t min_games,
+                        int (*compare)(const void *, const void *)) {
+    WordStats *words = malloc((table->used > 0 ? table->used : 1) * sizeof(WordStats));
+    if (words == NULL) {
+        perror("Failed to allocate word table");
+        exit(EXIT_FAILURE);
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->slots[i].word != WORD_NONE && table->slots[i].games >= min_games) {
+            words[count++] = table->slots[i];
+        }
+    }
+    qsort(words, count, sizeof(WordStats), compare);
+
+    printf("%s (%zu words):\n", title, count);
+    printf("  %-*s %10s %8s %8s\n", WORD_LENGTH, "word", "games", "solved", "average");
+    for (size_t i = 0; i < count && i < top; i++) {
+        char word[WORD_LENGTH + 1];
+        unpack_word(words[i].word, word);
+        printf("  %-*s %10u %7.2f%% %8.4f\n", WORD_LENGTH, word, words[i].games,
+               100.0 * words[i].won / words[i].games, difficulty(&words[i]));
+    }
+    free(words);
+}
+
+int main(int argc, char **argv) {
+    const char *log_path = NULL;
+    uint32_t source = SOURCE_ANY;
+    unsigned int required = 0;
+    size_t top = 10;
+    size_t min_games = 1;
+    int threads = 0;
+    bool usage = false;
+
+    for (int i = 1; i < argc && !usage; i++) {
+        if (strcmp(argv[i], "--source") == 0 && i + 1 < argc) {
+            i++;
+            source = SOURCE_ANY;
+            for (uint32_t s = 0; s < sizeof(source_names) / sizeof(source_names[0]); s++) {
+                if (strcmp(argv[i], source_names[s]) == 0) {
+                    source = s;
+                }
+            }
+            usage = source == SOURCE_ANY;
+        } else if (strcmp(argv[i], "--hard") == 0) {
+            required |= GAMELOG_HARD;
+        } else if (strcmp(argv[i], "--daily") == 0) {
+            required |= GAMELOG_DAILY;
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--min-games") == 0 && i + 1 < argc) {
+            min_games = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && log_path == NULL) {
+            log_path = argv[i];
+        } else {
+            usage = true;
+        }
+    }
+    if (usage || log_path == NULL) {
+        fprintf(stderr, "Usage: %s LOG [--source interactive|server|simulated] [--hard] [--daily]\n"
+                        "       [--top K] [--min-games N] [--threads N]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    GameLogView view;
+    if (!gamelog_map(log_path, &view)) {
+        return EXIT_FAILURE;
+    }
+
+    if (threads <= 0) {
+        threads = default_thread_count();
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    QueryJob job = {&view, source, required, (view.count + SCAN_CHUNK - 1) / SCAN_CHUNK, 0};
+    static QueryWorker workers[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        workers[t].job = &job;
+        table_init(&workers[t].secrets, TABLE_MIN_CAPACITY);
+        table_init(&workers[t].openers, TABLE_MIN_CAPACITY);
+    }
+
+    uint64_t start = monotonic_ns();
+    pthread_t handles[MAX_THREADS];
+    int started = 0;
+    // The calling thread is the first worker
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[started], NULL, query_worker, &workers[t]) != 0) {
+            break;
+        }
+        started++;
+    }
+    query_worker(&workers[0]);
+    for (int t = 0; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+
+    // Merge into the first worker's tallies
+    QueryWorker *total = &workers[0];
+    for (int t = 1; t <= started; t++) {
+        total->games += workers[t].games;
+        total->corrupt += workers[t].corrupt;
+        for (int s = 0; s <= GAMELOG_SOURCE_MASK; s++) {
+            total->by_source[s] += workers[t].by_source[s];
+        }
+        total->hard += workers[t].hard;
+        total->daily += workers[t].daily;
+        for (int k = 0; k < MAX_ATTEMPTS; k++) {
+            total->solved_in[k] += workers[t].solved_in[k];
+        }
+        total->failures += workers[t].failures;
+        table_merge(&total->secrets, &workers[t].secrets);
+        table_merge(&total->openers, &workers[t].openers);
+    }
+    double seconds = elapsed_seconds(start);
+
+    printf("Scanned %zu records in %.3f s on %d thread%s (%.1f M records/s); %zu games matched",
+           view.count, seconds, started + 1, started == 0 ? "" : "s",
+           seconds > 0 ? view.count / seconds / 1e6 : 0.0, total->games);
+    if (total->corrupt > 0) {
+        printf(", %zu corrupt records skipped", total->corrupt);
+    }
+    printf(".\n");
+    printf("Sources: %zu interactive, %zu server, %zu simulated (%zu hard, %zu daily)\n",
+           total->by_source[GAMELOG_INTERACTIVE], total->by_source[GAMELOG_SERVER],
+           total->by_source[GAMELOG_SIMULATED], total->hard, total->daily);
+
+    if (total->games > 0) {
+        size_t solved = total->games - total->failures;
+        size_t solved_guesses = 0;
+        for (int k = 0; k < MAX_ATTEMPTS; k++) {
+            solved_guesses += (size_t)(k + 1) * total->solved_in[k];
+        }
+        size_t guesses = solved_guesses + total->failures * MAX_ATTEMPTS;
+
+        printf("Solve rate: %.2f%% (%zu of %zu)\n", 100.0 * solved / total->games, solved, total->games);
+        printf("Average guesses: %.4f (solved games only: %.4f)\n", (double)guesses / total->games,
+               solved > 0 ? (double)solved_guesses / solved : 0.0);
+        printf("Distribution:\n");
+        for (int k = 0; k < MAX_ATTEMPTS; k++) {
+            printf("  %d: %zu (%.2f%%)\n", k + 1, total->solved_in[k], 100.0 * total->solved_in[k] / total->games);
+        }
+        printf("  X: %zu (%.2f%%)\n", total->failures, 100.0 * total->failures / total->games);
+
+        print_words("Hardest secrets", &total->secrets, top, min_games, compare_hardest);
+        print_words("Most played openers", &total->openers, top, min_games, compare_most_played);
+    }
+
+    for (int t = 0; t < threads; t++) {
+        table_free(&workers[t].secrets);
+        table_free(&workers[t].openers);
+    }
+    gamelog_unmap(&view);
+    return EXIT_SUCCESS;
+}
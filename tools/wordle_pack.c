@@ -0,0 +1,121 @@
+/*
+ * File: tools/wordle_pack.c
+ * Description: Offline compiler from a text word list to the binary
+ *   dictionary format read by the game (see dict.c).
+ *
+ * Usage:
+ *   wordle-pack [--no-freq] [--with-index] [--with-schedule [--schedule-start YYYY-MM-DD]
+ *               [--schedule-seed N]] <word_list.txt> <output.dict>
+ *
+ *   --no-freq         Omit the precomputed letter-frequency tables.
+ *   --with-index      Store the 1.5 MB guess-validation bitmap (see word_index.c).
+ *   --with-schedule   Store the word-of-the-day permutation (see daily.c),
+ *                     starting at puzzle #0 on --schedule-start and shuffled
+ *                     from --schedule-seed.
+ *
+ *   The word length is taken from the first line. Lists of 4, 6 or 7
+ *   letters are packed for the variant game and never carry the optional
+ *   sections.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "wordle.h"
+#include "wordlist.h"
+#include "dict.h"
+#include "variant.h"
+#include "daily.h"
+
+// 4-, 6- and 7-letter lists get only the word section
+static int pack_variant(const char *input, const char *output) {
+    VariantList list;
+    if (!variant_list_load(input, &list)) {
+        return EXIT_FAILURE;
+    }
+
+    bool ok = dict_write_variant(output, list.packed, list.count, list.variant->length);
+    if (ok) {
+        printf("Packed %zu %d-letter words into %s.\n", list.count, list.variant->length, output);
+    }
+
+    variant_list_free(&list);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int usage(const char *program) {
+    fprintf(stderr, "Usage: %s [--no-freq] [--with-index] [--with-schedule [--schedule-start YYYY-MM-DD]\n"
+                    "       [--schedule-seed N]] <word_list.txt> <output.dict>\n", program);
+    return EXIT_FAILURE;
+}
+
+int main(int argc, char **argv) {
+    unsigned int flags = DICT_HAS_LETTER_FREQ;
+    const char *input = NULL;
+    const char *output = NULL;
+    DictSchedule schedule = {0, 0, DAILY_DEFAULT_SEED};
+    int64_t start;
+
+    daily_parse_date(DAILY_DEFAULT_START, &start);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-freq") == 0) {
+            flags &= ~DICT_HAS_LETTER_FREQ;
+        } else if (strcmp(argv[i], "--with-index") == 0) {
+            flags |= DICT_HAS_WORD_INDEX;
+        } else if (strcmp(argv[i], "--with-schedule") == 0) {
+            flags |= DICT_HAS_SCHEDULE;
+        } else if (strcmp(argv[i], "--schedule-start") == 0 && i + 1 < argc) {
+            if (!daily_parse_date(argv[++i], &start)) {
+                fprintf(stderr, "Invalid date '%s'; expected YYYY-MM-DD.\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--schedule-seed") == 0 && i + 1 < argc) {
+            schedule.seed = strtoull(argv[++i], NULL, 10);
+        } else if (input == NULL) {
+            input = argv[i];
+        } else if (output == NULL) {
+            output = argv[i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (input == NULL || output == NULL) {
+        return usage(argv[0]);
+    }
+
+    int length = variant_detect_length(input);
+    if (length != WORD_LENGTH && word_variant(length) != NULL) {
+        return pack_variant(input, output);
+    }
+
+    WordList list;
+    if (!wordlist_load(input, &list)) {
+        return EXIT_FAILURE;
+    }
+
+    schedule.epoch_day = (int32_t)start;
+    bool ok = dict_write(output, list.packed, list.count, flags, &schedule);
+    if (ok) {
+        const char *sections[3];
+        int n = 0;
+        if (flags & DICT_HAS_LETTER_FREQ) {
+            sections[n++] = "letter-frequency tables";
+        }
+        if (flags & DICT_HAS_WORD_INDEX) {
+            sections[n++] = "a validation index";
+        }
+        if (flags & DICT_HAS_SCHEDULE) {
+            sections[n++] = "a daily schedule";
+        }
+        printf("Packed %zu words into %s", list.count, output);
+        for (int s = 0; s < n; s++) {
+            printf("%s%s", s == 0 ? " with " : s == n - 1 ? " and " : ", ", sections[s]);
+        }
+        printf(".\n");
+    }
+
+    wordlist_free(&list);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
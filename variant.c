@@ -0,0 +1,282 @@
+/*
+ * File: variant.c
+ * Description: Scoring kernels for 4- to 7-letter Wordle variants.
+ *
+ *   DEFINE_VARIANT stamps out a full set of kernels for one word length,
+ *   so every loop has a constant trip count the compiler unrolls and every
+ *   variant has a fixed 3^L pattern space. word_variant() picks the set for
+ *   the length a dictionary declares, which lets one binary serve every
+ *   length wordle-pack can produce.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "score.h"
+#include "dict.h"
+#include "variant.h"
+
+static const uint16_t pow3[VARIANT_MAX_LENGTH] = {1, 3, 9, 27, 81, 243, 729};
+
+// The kernels mirror pack_word, unpack_word, score_packed and
+// pattern_to_scores with WORD_LENGTH replaced by L
+#define DEFINE_VARIANT(L)                                                               \
+    static uint64_t pack_##L(const char *word) {                                        \
+        uint64_t packed = 0;                                                            \
+        _Pragma("GCC unroll 8")                                                         \
+        for (int i = 0; i < L; i++) {                                                   \
+            unsigned int letter = (unsigned char)(word[i] | 0x20) - 'a';                \
+            if (letter > 25) {                                                          \
+                letter = LETTER_INVALID;                                                \
+            }                                                                           \
+            packed |= (uint64_t)letter << (LETTER_BITS * i);                            \
+        }                                                                               \
+        return packed;                                                                  \
+    }                                                                                   \
+                                                                                        \
+    static void unpack_##L(uint64_t packed, char *word) {                               \
+        _Pragma("GCC unroll 8")                                                         \
+        for (int i = 0; i < L; i++) {                                                   \
+            unsigned int letter = (packed >> (LETTER_BITS * i)) & LETTER_MASK;          \
+            word[i] = letter < 26 ? (char)('a' + letter) : '?';                         \
+        }                                                                               \
+        word[L] = '\0';                                                                 \
+    }                                                                                   \
+                                                                                        \
+    static uint16_t score_##L(uint64_t secret, uint64_t guess) {                        \
+        uint8_t counts[LETTER_MASK + 1];                                                \
+        unsigned int green[L];                                                          \
+        unsigned int pattern = 0;                                                       \
+                                                                                        \
+        memset(counts, 0, sizeof(counts));                                              \
+        _Pragma("GCC unroll 8")                                                         \
+        for (int i = 0; i < L; i++) {                                                   \
+            unsigned int s = (secret >> (LETTER_BITS * i)) & LETTER_MASK;               \
+            unsigned int g = (guess >> (LETTER_BITS * i)) & LETTER_MASK;                \
+            green[i] = s == g;                                                          \
+            counts[s] += !green[i];                                                     \
+        }                                                                               \
+        _Pragma("GCC unroll 8")                                                         \
+        for (int i = 0; i < L; i++) {                                                   \
+            unsigned int g = (guess >> (LETTER_BITS * i)) & LETTER_MASK;                \
+            unsigned int yellow = !green[i] & (counts[g] != 0);                         \
+            counts[g] -= yellow;                                                        \
+            pattern += (green[i] * CORRECT_LETTER_CORRECT_POSITION +                    \
+                        yellow * CORRECT_LETTER_WRONG_POSITION) * pow3[i];              \
+        }                                                                               \
+        return (uint16_t)pattern;                                                       \
+    }                                                                                   \
+                                                                                        \
+    static void score_batch_##L(uint64_t guess, const uint64_t *secrets, size_t n,      \
+                                uint16_t *out_patterns) {                               \
+        for (size_t s = 0; s < n; s++) {                                                \
+            out_patterns[s] = score_##L(secrets[s], guess);                             \
+        }                                                                               \
+    }                                                                                   \
+                                                                                        \
+    static void to_scores_##L(uint16_t pattern, int *scores) {                          \
+        _Pragma("GCC unroll 8")                                                         \
+        for (int i = 0; i < L; i++) {                                                   \
+            scores[i] = pattern % 3;                                                    \
+            pattern /= 3;                                                               \
+        }                                                                               \
+    }
+
+#define VARIANT_ENTRY(L, PATTERNS) \
+    {L, VARIANT_ATTEMPTS(L), PATTERNS, PATTERNS - 1, pack_##L, unpack_##L, score_##L, score_batch_##L, to_scores_##L}
+
+DEFINE_VARIANT(4)
+DEFINE_VARIANT(5)
+DEFINE_VARIANT(6)
+DEFINE_VARIANT(7)
+
+static const WordVariant variants[] = {
+    VARIANT_ENTRY(4, 81),
+    VARIANT_ENTRY(5, 243),
+    VARIANT_ENTRY(6, 729),
+    VARIANT_ENTRY(7, 2187),
+};
+
+const WordVariant *word_variant(int length) {
+    if (length < VARIANT_MIN_LENGTH || length > VARIANT_MAX_LENGTH) {
+        return NULL;
+    }
+    return &variants[length - VARIANT_MIN_LENGTH];
+}
+
+// Word length of a list: the header's for a binary dictionary, otherwise
+// the length of the first non-empty line. Returns 0 if it can't tell.
+int variant_detect_length(const char *filename) {
+    char head[sizeof(DictHeader)];
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    ssize_t got = read(fd, head, sizeof(head));
+    close(fd);
+    if (got <= 0) {
+        return 0;
+    }
+
+    if (dict_is_binary(head, (size_t)got)) {
+        return ((const DictHeader *)head)->word_length;
+    }
+
+    int length = 0;
+    for (ssize_t i = 0; i < got; i++) {
+        if (head[i] == '\n' || head[i] == '\r') {
+            if (length > 0) {
+                return length;
+            }
+        } else {
+            length++;
+        }
+    }
+    return 0;
+}
+
+static int compare_packed(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static bool allocate_words(size_t capacity, int length, VariantList *list) {
+    list->letters = malloc(capacity * (size_t)length + 1);
+    list->packed = malloc(capacity * sizeof(uint64_t) + 1);
+    list->count = 0;
+    if (list->letters == NULL || list->packed == NULL) {
+        perror("Failed to allocate word list");
+        variant_list_free(list);
+        return false;
+    }
+    return true;
+}
+
+static bool parse_text(const char *data, size_t size, VariantList *list) {
+    const WordVariant *v = list->variant;
+    if (!allocate_words(size / (size_t)(v->length + 1) + 1, v->length, list)) {
+        return false;
+    }
+
+    const char *end = data + size;
+    for (const char *line = data; line < end;) {
+        const char *newline = memchr(line, '\n', (size_t)(end - line));
+        if (newline == NULL) {
+            newline = end;
+        }
+        size_t length = (size_t)(newline - line);
+        if (length > 0 && line[length - 1] == '\r') {
+            length--;
+        }
+
+        if (length == (size_t)v->length) {
+            char *word = list->letters + list->count * length;
+            unsigned int invalid = 0;
+            for (size_t i = 0; i < length; i++) {
+                char c = (char)(line[i] | 0x20);
+                invalid |= (unsigned char)(c - 'a') > 'z' - 'a';
+                word[i] = c;
+            }
+            if (!invalid) {
+                list->packed[list->count++] = v->pack(word);
+            }
+        }
+
+        line = newline + 1;
+    }
+
+    return true;
+}
+
+static bool decode_binary(const void *data, size_t size, VariantList *list) {
+    DictView view;
+    if (!dict_view(data, size, &view) || !allocate_words(view.count, view.word_length, list)) {
+        return false;
+    }
+
+    char word[VARIANT_MAX_LENGTH + 1];
+    for (size_t i = 0; i < view.count; i++) {
+        uint64_t packed = dict_variant_word(&view, i);
+        list->variant->unpack(packed, word);
+        memcpy(list->letters + i * (size_t)view.word_length, word, (size_t)view.word_length);
+        list->packed[i] = packed;
+    }
+    list->count = view.count;
+
+    return true;
+}
+
+bool variant_list_load(const char *filename, VariantList *list) {
+    memset(list, 0, sizeof(*list));
+
+    int length = variant_detect_length(filename);
+    list->variant = word_variant(length);
+    if (list->variant == NULL) {
+        fprintf(stderr, "Unsupported word length in %s (expected %d to %d letters).\n",
+                filename, VARIANT_MIN_LENGTH, VARIANT_MAX_LENGTH);
+        return false;
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open file");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror("Failed to stat file");
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *data = size > 0 ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("Failed to map file");
+        return false;
+    }
+
+    bool ok = dict_is_binary(data, size) ? decode_binary(data, size, list)
+                                         : parse_text(data, size, list);
+    if (data != NULL) {
+        munmap(data, size);
+    }
+    if (!ok) {
+        return false;
+    }
+
+    if (list->count == 0) {
+        fprintf(stderr, "No valid words found in the file.\n");
+        variant_list_free(list);
+        return false;
+    }
+
+    list->sorted = malloc(list->count * sizeof(uint64_t));
+    if (list->sorted == NULL) {
+        perror("Failed to allocate word list");
+        variant_list_free(list);
+        return false;
+    }
+    memcpy(list->sorted, list->packed, list->count * sizeof(uint64_t));
+    qsort(list->sorted, list->count, sizeof(uint64_t), compare_packed);
+
+    return true;
+}
+
+bool variant_list_contains(const VariantList *list, uint64_t packed) {
+    return bsearch(&packed, list->sorted, list->count, sizeof(uint64_t), compare_packed) != NULL;
+}
+
+void variant_list_free(VariantList *list) {
+    free(list->letters);
+    free(list->packed);
+    free(list->sorted);
+    memset(list, 0, sizeof(*list));
+}
@@ -0,0 +1,59 @@
+// variant.h
+
+#ifndef VARIANT_H
+#define VARIANT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordle.h"
+
+// Word lengths one binary can play. The classic game, its solver, matrix
+// and server stay on the 5-letter kernels in score.c; every length here,
+// 5 included, gets its own macro-generated kernel below.
+#define VARIANT_MIN_LENGTH 4
+#define VARIANT_MAX_LENGTH 7
+#define VARIANT_PATTERN_MAX 2187   // 3^VARIANT_MAX_LENGTH
+
+// Players get one more attempt than there are letters, as in the 5/6 game
+#define VARIANT_ATTEMPTS(length) ((length) + 1)
+#define VARIANT_MAX_ATTEMPTS VARIANT_ATTEMPTS(VARIANT_MAX_LENGTH)
+
+// One word length's kernels. Words pack five bits per letter into a
+// uint64_t (35 bits at seven letters) exactly like pack_word, and patterns
+// are base-3 numbers below pattern_count, so they need 16 bits past five.
+typedef struct {
+    int length;
+    int max_attempts;
+    uint16_t pattern_count;     // 3^length
+    uint16_t pattern_solved;
+    uint64_t (*pack)(const char *word);
+    void (*unpack)(uint64_t packed, char *word);
+    uint16_t (*score)(uint64_t secret, uint64_t guess);
+    void (*score_batch)(uint64_t guess, const uint64_t *secrets, size_t n, uint16_t *out_patterns);
+    void (*to_scores)(uint16_t pattern, int *scores);
+} WordVariant;
+
+// A word list of any supported length. Word i is
+// letters[i * length .. i * length + length); sorted holds the packed words
+// in ascending order for membership checks.
+typedef struct {
+    const WordVariant *variant;
+    char *letters;
+    uint64_t *packed;
+    uint64_t *sorted;
+    size_t count;
+} VariantList;
+
+// Function declarations
+const WordVariant *word_variant(int length);
+int variant_detect_length(const char *filename);
+bool variant_list_load(const char *filename, VariantList *list);
+bool variant_list_contains(const VariantList *list, uint64_t packed);
+void variant_list_free(VariantList *list);
+
+static inline const char *variant_list_word(const VariantList *list, size_t index) {
+    return list->letters + index * (size_t)list->variant->length;
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * File: word_index.c
+ * Description: Constant-time dictionary membership.
+ *
+ *   Guess validation uses a bitmap over every possible 5-letter string,
+ *   indexed by the word's base-26 rank, so "is this a real word" is one
+ *   shift-and-mask. The bitmap is built from the word list at load time,
+ *   or mapped straight out of a binary dictionary that stores it (see
+ *   wordle-pack --with-index).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "dict.h"
+#include "word_index.h"
+
+void word_index_fill(const uint32_t *packed, size_t count, uint64_t *bits) {
+    memset(bits, 0, WORD_INDEX_BYTES);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t rank = word_rank(packed[i]);
+        if (rank != WORD_RANK_INVALID) {
+            bits[rank / 64] |= UINT64_C(1) << (rank % 64);
+        }
+    }
+}
+
+void word_index_build(const WordList *list, WordIndex *index) {
+    memset(index, 0, sizeof(*index));
+    index->owned = malloc(WORD_INDEX_BYTES);
+    if (index->owned == NULL) {
+        perror("Failed to allocate word index");
+        exit(EXIT_FAILURE);
+    }
+
+    word_index_fill(list->packed, list->count, index->owned);
+    index->bits = index->owned;
+}
+
+// Maps the bitmap stored in a binary dictionary; false for text lists and
+// dictionaries packed without one, leaving index untouched
+bool word_index_map(const char *words_file, WordIndex *index) {
+    DictView view;
+
+    int fd = open(words_file, O_RDONLY);
+    DictHeader header;
+    bool binary = fd >= 0 && read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+                  dict_is_binary(&header, sizeof(header));
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    if (binary && dict_map(words_file, &view)) {
+        if (view.index != NULL) {
+            memset(index, 0, sizeof(*index));
+            index->bits = view.index;
+            index->map = view.map;
+            index->map_size = view.map_size;
+            return true;
+        }
+        dict_unmap(&view);
+    }
+
+    return false;
+}
+
+// Returns true when the index was mapped from the dictionary file rather
+// than built from the list
+bool word_index_open(const char *words_file, const WordList *list, WordIndex *index) {
+    // Only binary dictionaries can carry a stored index; quietly fall back
+    // to building one for text lists or dictionaries packed without it
+    if (word_index_map(words_file, index)) {
+        return true;
+    }
+
+    word_index_build(list, index);
+    return false;
+}
+
+// A guess list's stored index also serves a split list, but only when the
+// guess list already held every answer; otherwise the index is built over
+// the combined list
+bool word_index_open_split(const char *guesses_file, const WordList *list, WordIndex *index) {
+    if (word_index_map(guesses_file, index)) {
+        size_t i = 0;
+        while (i < list->answer_count && word_index_contains(index, list->packed[i])) {
+            i++;
+        }
+        if (i == list->answer_count) {
+            return true;
+        }
+        word_index_free(index);
+    }
+
+    word_index_build(list, index);
+    return false;
+}
+
+void word_index_free(WordIndex *index) {
+    if (index->map != NULL) {
+        munmap(index->map, index->map_size);
+    }
+    free(index->owned);
+    memset(index, 0, sizeof(*index));
+}
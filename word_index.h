@@ -0,0 +1,54 @@
+// word_index.h
+
+#ifndef WORD_INDEX_H
+#define WORD_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordle.h"
+#include "wordlist.h"
+#include "score.h"
+
+// One bit per possible 5-letter word, addressed by its base-26 rank:
+// 26^5 = 11,881,376 bits, just under 1.5 MB
+#define WORD_INDEX_BITS 11881376u
+#define WORD_INDEX_WORDS ((WORD_INDEX_BITS + 63) / 64)
+#define WORD_INDEX_BYTES (WORD_INDEX_WORDS * sizeof(uint64_t))
+#define WORD_RANK_INVALID UINT32_MAX
+
+typedef struct {
+    const uint64_t *bits;
+    uint64_t *owned;        // heap bitmap when built in this process
+    void *map;              // mapped dictionary holding a stored bitmap
+    size_t map_size;
+} WordIndex;
+
+// Function declarations
+void word_index_build(const WordList *list, WordIndex *index);
+void word_index_fill(const uint32_t *packed, size_t count, uint64_t *bits);
+bool word_index_map(const char *words_file, WordIndex *index);
+bool word_index_open(const char *words_file, const WordList *list, WordIndex *index);
+bool word_index_open_split(const char *guesses_file, const WordList *list, WordIndex *index);
+void word_index_free(WordIndex *index);
+
+// Base-26 rank of a packed word, or WORD_RANK_INVALID for non-letters
+static inline uint32_t word_rank(uint32_t packed) {
+    uint32_t rank = 0;
+    uint32_t invalid = 0;
+
+    for (int i = WORD_LENGTH - 1; i >= 0; i--) {
+        uint32_t letter = (packed >> (LETTER_BITS * i)) & LETTER_MASK;
+        invalid |= letter > 25;
+        rank = rank * 26 + letter;
+    }
+
+    return invalid ? WORD_RANK_INVALID : rank;
+}
+
+static inline bool word_index_contains(const WordIndex *index, uint32_t packed) {
+    uint32_t rank = word_rank(packed);
+    return rank != WORD_RANK_INVALID && ((index->bits[rank / 64] >> (rank % 64)) & 1);
+}
+
+#endif
@@ -24,52 +24,76 @@
  * Functions:
  *   - void check_guess(const char *secret, const char *guess, int *result):
  *       Compares the user's guess with the secret word and fills the result array with appropriate score.
+ *       Scoring itself is done by the packed kernel in score.c (see score_packed);
+ *       words holding anything but letters are compared byte by byte as before,
+ *       since packing folds every non-letter into one code.
  *
- *   - char* choose_random_word(const char* filename):
- *       Reads words from a file, selects a random valid word, and returns it.
+ *   - void choose_random_word(const char *filename, char *word):
+ *       Reads words from a file, selects a random valid word, and copies it
+ *       into word (WORD_LENGTH + 1 bytes, NUL-terminated).
+ *       Dictionaries and text lists with an offsets file are read one word
+ *       at a time instead (see startup.c).
+ *
+ *   - void choose_random_word_from(const WordList *list, char *word):
+ *       Selects a random answer from an already loaded word list (see wordlist.c)
+ *       into the caller's buffer in the same way.
  *
  *   - void display_result(const char *guess, const int *result):
  *       Displays the user's guess with color-coded feedback based on the result array.
+ *       The row is built by render.c and written with a single write().
  *
  * Usage:
  *   - Ensure that `word_list.txt` contains a list of valid 5-letter words, one per line.
- *   - Compile the program using a C compiler (e.g., gcc).
+ *   - Compile the program using a C compiler (see README.md for the full command).
  *   - Run the executable and follow the prompts to guess the secret word.
+ *   - The entry point and command-line modes live in main.c.
  *
  * Note:
  *   - The program assumes that the `word_list.txt` file is located in the same directory as the executable.
- *   - Memory allocated with `strdup` is freed before the program exits to avoid memory leaks.
+ *   - Chosen words are written into a buffer the caller owns, so nothing is
+ *     allocated per game and nothing has to be freed.
  *   - Colors are displayed using ANSI escape codes and may not be supported by all terminals.
  */
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <stdbool.h>
 #include <ctype.h>
-#include <time.h>
+#include <stdbool.h>
+#include <unistd.h>
 #include "wordle.h"
+#include "score.h"
+#include "wordlist.h"
+#include "rng.h"
+#include "render.h"
+#include "metrics.h"
+#include "startup.h"
+
+static bool packed_has_invalid(uint32_t packed) {
+    for (int i = 0; i < WORD_LENGTH; i++) {
+        if (((packed >> (LETTER_BITS * i)) & LETTER_MASK) == LETTER_INVALID) {
+            return true;
+        }
+    }
+    return false;
+}
 
-void check_guess(const char *secret, const char *guess, int *scores) {
-    bool letter_used[WORD_LENGTH] = {false}; // Track used letters in the secret word
+// The original case-insensitive comparison, for words the packed form
+// cannot tell apart: "ab1de" and "ab2de" pack the same middle letter
+static void check_guess_bytes(const char *secret, const char *guess, int *scores) {
+    bool letter_used[WORD_LENGTH] = {false};
 
-    // Initialize the result array with zeroes
-    // This is critical to calculating the correct score for each guess
     memset(scores, 0, WORD_LENGTH * sizeof(int));
-
-    // First pass: Check for correct positions
     for (int i = 0; i < WORD_LENGTH; i++) {
-        if (tolower(guess[i]) == tolower(secret[i])) {
+        if (tolower((unsigned char)guess[i]) == tolower((unsigned char)secret[i])) {
             scores[i] = CORRECT_LETTER_CORRECT_POSITION;
             letter_used[i] = true;
         }
     }
-
-    // Second pass: Check for correct letters in wrong positions
     for (int i = 0; i < WORD_LENGTH; i++) {
         if (scores[i] != CORRECT_LETTER_CORRECT_POSITION) {
             for (int j = 0; j < WORD_LENGTH; j++) {
-                if (!letter_used[j] && tolower(guess[i]) == tolower(secret[j])) {
+                if (!letter_used[j] && tolower((unsigned char)guess[i]) == tolower((unsigned char)secret[j])) {
                     scores[i] = CORRECT_LETTER_WRONG_POSITION;
                     letter_used[j] = true;
                     break;
@@ -79,100 +103,60 @@ void check_guess(const char *secret, const char *guess, int *scores) {
     }
 }
 
-char *choose_random_word(const char *filename) {
-    FILE *file = fopen(filename, "r");
-    if (file == NULL) {
-        perror("Failed to open file");
-        exit(EXIT_FAILURE);
+void check_guess(const char *secret, const char *guess, int *scores) {
+    // The packed kernel does the work; this keeps the per-letter interface
+    // that display_result and the game loop use
+    uint64_t start = metrics_sample_start();
+    uint32_t secret_packed = pack_word(secret);
+    uint32_t guess_packed = pack_word(guess);
+    if (packed_has_invalid(secret_packed) || packed_has_invalid(guess_packed)) {
+        check_guess_bytes(secret, guess, scores);
+    } else {
+        pattern_to_scores(score_packed(secret_packed, guess_packed), scores);
     }
+    metrics_sample_end(HISTOGRAM_CHECK_GUESS, start);
+    metrics_add(METRIC_GUESSES_SCORED, 1);
+}
 
-    char word[MAX_WORDS][WORD_LENGTH + 1];
-    int word_count = 0;
-
-    // Read words from the file
-    while (fgets(word[word_count], sizeof(word[word_count]), file)) {
-        // Remove newline character if present
-        word[word_count][strcspn(word[word_count], "\n")] = '\0';
+void choose_random_word(const char *filename, char *word) {
+    size_t index;
+    uint32_t packed;
 
-        // Check if the word length matches the required word length
-        if (strlen(word[word_count]) == WORD_LENGTH) {
-            word_count++;
-            if (word_count >= MAX_WORDS) break; // Prevent overflow
-        }
+    // One record read when the file supports it, the full load otherwise
+    if (startup_pick_secret(filename, rng_thread(), &index, &packed)) {
+        unpack_word(packed, word);
+        metrics_add(METRIC_SECRETS_CHOSEN, 1);
+        return;
     }
 
-    fclose(file);
-
-    if (word_count == 0) {
-        fprintf(stderr, "No valid words found in the file.\n");
+    WordList list;
+    if (!wordlist_load(filename, &list)) {
         exit(EXIT_FAILURE);
     }
 
-    srand(time(NULL));
-    int random_index = rand() % word_count;
-    char *chosen_word = strdup(word[random_index]); // strdup allocates memory for the chosen word
-
-    return chosen_word;
-}
-
-void display_result(const char *guess, const int *result) {
-    printf("Result: ");
-    for (int i = 0; i < WORD_LENGTH; i++) {
-        if (result[i] == CORRECT_LETTER_CORRECT_POSITION) {
-            // Correct letter and position (green background)
-            printf("%s%c%s ", GREEN_BACKGROUND WHITE_TEXT, toupper(guess[i]), RESET_COLOR);
-        } else if (result[i] == CORRECT_LETTER_WRONG_POSITION) {
-            // Correct letter, wrong position (yellow background)
-            printf("%s%c%s ", YELLOW_BACKGROUND WHITE_TEXT, toupper(guess[i]), RESET_COLOR);
-        } else {
-            // Incorrect letter (grey background)
-            printf("%s%c%s ", GREY_BACKGROUND WHITE_TEXT, toupper(guess[i]), RESET_COLOR);
-        }
-    }
-    printf("\n");
+    choose_random_word_from(&list, word);
+    wordlist_free(&list);
 }
 
-int main(void) {
-    char *secret_word = choose_random_word("word_list.txt");
-    char guess[WORD_LENGTH + 1];
-    int scores[WORD_LENGTH];
-    int attempts = 0;
-    bool guessed_correctly = false;
-
-    printf("Welcome to Wordle!\n");
-    printf("Guess the %d-letter word. You have %d attempts.\n", WORD_LENGTH, MAX_ATTEMPTS);
-
-    while (attempts < MAX_ATTEMPTS && !guessed_correctly) {
-        printf("Attempt %d of %d: ", attempts + 1, MAX_ATTEMPTS);
-        scanf("%s", guess);
-
-        // Ensure the guess is the correct length
-        if (strlen(guess) != WORD_LENGTH) {
-            printf("Please enter a %d-letter word.\n", WORD_LENGTH);
-            continue;
-        }
-
-        check_guess(secret_word, guess, scores);
-        display_result(guess, scores);
-
-        // Calculate the total points
-        int total_points = 0;
-        for (int i = 0; i < WORD_LENGTH; i++) {
-            total_points += scores[i];
-        }
+// `word` receives WORD_LENGTH letters and a NUL
+void choose_random_word_from(const WordList *list, char *word) {
+    // Per-thread generator: no shared rand() state, no modulo bias
+    // Only the answer prefix of a split list can be the secret
+    size_t random_index = (size_t)rng_bounded(rng_thread(), list->answer_count);
+    metrics_add(METRIC_SECRETS_CHOSEN, 1);
 
-        if (total_points == WORD_LENGTH * CORRECT_LETTER_CORRECT_POSITION) {
-            guessed_correctly = true;
-            printf("Congratulations! You've guessed the word!\n");
-        } else {
-            attempts++;
-        }
-    }
-
-    if (!guessed_correctly) {
-        printf("Sorry, you've run out of attempts. The word was '%s'.\n", secret_word);
-    }
+    memcpy(word, wordlist_word(list, random_index), WORD_LENGTH);
+    word[WORD_LENGTH] = '\0';
+}
 
-    free(secret_word);
-    return EXIT_SUCCESS;
+void display_result(const char *guess, const int *result) {
+    char line[sizeof("Result: ") - 1 + RENDER_ROW_MAX];
+    size_t length = sizeof("Result: ") - 1;
+
+    // Build the whole row first and hand it to the terminal in one write;
+    // flushing stdout keeps it ordered after any pending prompt
+    memcpy(line, "Result: ", length);
+    length += render_row(line + length, guess, scores_to_pattern(result), RENDER_COLOR);
+    fflush(stdout);
+    render_emit(STDOUT_FILENO, line, length);
 }
@@ -5,7 +5,14 @@
 
 #define WORD_LENGTH 5
 #define MAX_ATTEMPTS 6
-#define MAX_WORDS 1500
+#define MAX_THREADS 256
+
+#define WORD_LIST_FILE "word_list.txt"
+#define PATTERN_CACHE_FILE "word_list.patterns"
+#define STRATEGY_FILE "word_list.strategy"
+
+// Memory allowed for cached per-guess pattern bitsets (see pattern_index.c)
+#define PATTERN_INDEX_BUDGET (16u << 20)
 
 #define CORRECT_LETTER_CORRECT_POSITION 2
 #define CORRECT_LETTER_WRONG_POSITION 1
@@ -17,9 +24,12 @@
 #define GREY_BACKGROUND "\033[100m"
 #define WHITE_TEXT "\033[97m"
 
+typedef struct WordList WordList;
+
 // Function declarations
 void check_guess(const char *secret, const char *guess, int *result);
-char* choose_random_word(const char* filename);
+void choose_random_word(const char *filename, char *word);
+void choose_random_word_from(const WordList *list, char *word);
 void display_result(const char *guess, const int *result);
 
 #endif
@@ -0,0 +1,238 @@
+/*
+ * File: wordlist.c
+ * Description: Word-list loader.
+ *
+ *   The whole file is mapped in one call and then walked once: each line is
+ *   checked for exactly WORD_LENGTH ASCII letters, lowercased and appended
+ *   to a single WORD_LENGTH-strided buffer alongside its packed form. There
+ *   is no fixed cap on the number of words. Binary dictionaries produced by
+ *   wordle-pack (see dict.c) are recognised by their magic and decoded
+ *   straight from the mapping.
+ *
+ *   wordlist_load_split joins an answer list and an allowed-guess list into
+ *   one WordList, answers first, so a secret index, a guess index and a
+ *   matrix column all mean the same word.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "score.h"
+#include "dict.h"
+#include "wordlist.h"
+#include "metrics.h"
+
+static bool allocate_words(size_t capacity, WordList *list) {
+    list->letters = malloc(capacity * WORD_LENGTH + 1);
+    list->packed = malloc(capacity * sizeof(*list->packed) + 1);
+    list->count = 0;
+    if (list->letters == NULL || list->packed == NULL) {
+        perror("Failed to allocate word list");
+        wordlist_free(list);
+        return false;
+    }
+    return true;
+}
+
+// Finds the next line holding exactly WORD_LENGTH letters, copies them
+// lowercased into word and returns where the line starts, or NULL at the
+// end of the data. *cursor moves past the line.
+static const char *next_text_word(const char **cursor, const char *end, char *word) {
+    while (*cursor < end) {
+        const char *line = *cursor;
+        const char *newline = memchr(line, '\n', (size_t)(end - line));
+        if (newline == NULL) {
+            newline = end;
+        }
+        *cursor = newline + 1;
+
+        size_t length = (size_t)(newline - line);
+        if (length > 0 && line[length - 1] == '\r') {
+            length--;
+        }
+        if (length != WORD_LENGTH) {
+            continue;
+        }
+
+        unsigned int invalid = 0;
+        for (int i = 0; i < WORD_LENGTH; i++) {
+            // Folding in the 0x20 bit maps 'A'..'Z' onto 'a'..'z'
+            char c = (char)(line[i] | 0x20);
+            invalid |= (unsigned char)(c - 'a') > 'z' - 'a';
+            word[i] = c;
+        }
+        if (!invalid) {
+            return line;
+        }
+    }
+
+    return NULL;
+}
+
+static bool parse_text(const char *data, size_t size, WordList *list) {
+    // A word takes at least WORD_LENGTH + 1 bytes including its newline,
+    // which bounds the output without a second pass
+    if (!allocate_words(size / (WORD_LENGTH + 1) + 1, list)) {
+        return false;
+    }
+
+    const char *end = data + size;
+    const char *cursor = data;
+    char *word = list->letters;
+    while (next_text_word(&cursor, end, word) != NULL) {
+        list->packed[list->count++] = pack_word(word);
+        word += WORD_LENGTH;
+    }
+
+    return true;
+}
+
+// Byte offset of every word line of a text list, in load order, so word i
+// can be read back without parsing the lines before it. offsets must hold
+// size / (WORD_LENGTH + 1) + 1 entries; returns how many were written.
+size_t wordlist_text_offsets(const char *data, size_t size, uint32_t *offsets) {
+    const char *end = data + size;
+    const char *cursor = data;
+    const char *line;
+    char word[WORD_LENGTH];
+    size_t count = 0;
+
+    while ((line = next_text_word(&cursor, end, word)) != NULL) {
+        offsets[count++] = (uint32_t)(line - data);
+    }
+
+    return count;
+}
+
+static bool decode_binary(const void *data, size_t size, WordList *list) {
+    DictView view;
+    if (!dict_view(data, size, &view)) {
+        return false;
+    }
+    if (view.word_length != WORD_LENGTH) {
+        fprintf(stderr, "This mode needs %d-letter words; the dictionary has %d-letter words.\n",
+                WORD_LENGTH, view.word_length);
+        return false;
+    }
+    if (!allocate_words(view.count, list)) {
+        return false;
+    }
+
+    // The dictionary holds 25-bit records; expand them to the strided
+    // letters and aligned packed words the rest of the game uses
+    char word[WORD_LENGTH + 1];
+    for (size_t i = 0; i < view.count; i++) {
+        uint32_t packed = dict_word(&view, i);
+        unpack_word(packed, word);
+        memcpy(list->letters + i * WORD_LENGTH, word, WORD_LENGTH);
+        list->packed[i] = packed;
+    }
+    list->count = view.count;
+
+    return true;
+}
+
+bool wordlist_load(const char *filename, WordList *list) {
+    uint64_t start = monotonic_ns();
+    memset(list, 0, sizeof(*list));
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open file");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror("Failed to stat file");
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *data = size > 0 ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("Failed to map file");
+        return false;
+    }
+
+    // Binary dictionaries from wordle-pack and plain text lists are both
+    // accepted; the magic number tells them apart
+    bool ok = dict_is_binary(data, size) ? decode_binary(data, size, list)
+                                         : parse_text(data, size, list);
+    if (data != NULL) {
+        munmap(data, size);
+    }
+    if (!ok) {
+        return false;
+    }
+
+    if (list->count == 0) {
+        fprintf(stderr, "No valid words found in the file.\n");
+        wordlist_free(list);
+        return false;
+    }
+
+    list->answer_count = list->count;
+    metrics_observe(HISTOGRAM_DICT_LOAD, monotonic_ns() - start);
+    return true;
+}
+
+static int compare_packed(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+bool wordlist_load_split(const char *answers_file, const char *guesses_file, WordList *list) {
+    WordList answers, guesses;
+    if (!wordlist_load(answers_file, &answers)) {
+        return false;
+    }
+    if (!wordlist_load(guesses_file, &guesses)) {
+        wordlist_free(&answers);
+        return false;
+    }
+
+    // Guesses that are also answers are dropped, found by binary search
+    // over a sorted copy of the answers
+    uint32_t *sorted = malloc(answers.count * sizeof(uint32_t));
+    if (sorted == NULL || !allocate_words(answers.count + guesses.count, list)) {
+        if (sorted == NULL) {
+            perror("Failed to allocate word list");
+        }
+        free(sorted);
+        wordlist_free(&answers);
+        wordlist_free(&guesses);
+        return false;
+    }
+    memcpy(sorted, answers.packed, answers.count * sizeof(uint32_t));
+    qsort(sorted, answers.count, sizeof(uint32_t), compare_packed);
+
+    memcpy(list->letters, answers.letters, answers.count * WORD_LENGTH);
+    memcpy(list->packed, answers.packed, answers.count * sizeof(uint32_t));
+    list->count = answers.count;
+    list->answer_count = answers.count;
+    for (size_t i = 0; i < guesses.count; i++) {
+        if (bsearch(&guesses.packed[i], sorted, answers.count, sizeof(uint32_t), compare_packed) != NULL) {
+            continue;
+        }
+        memcpy(list->letters + list->count * WORD_LENGTH, wordlist_word(&guesses, i), WORD_LENGTH);
+        list->packed[list->count++] = guesses.packed[i];
+    }
+
+    free(sorted);
+    wordlist_free(&answers);
+    wordlist_free(&guesses);
+    return true;
+}
+
+void wordlist_free(WordList *list) {
+    free(list->letters);
+    free(list->packed);
+    memset(list, 0, sizeof(*list));
+}
@@ -0,0 +1,37 @@
+// wordlist.h
+
+#ifndef WORDLIST_H
+#define WORDLIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wordle.h"
+
+// A loaded dictionary shared by the game, the solver and the benchmarks.
+// Word i is letters[i * WORD_LENGTH .. i * WORD_LENGTH + WORD_LENGTH), always
+// lowercase and not NUL-terminated; packed[i] is the same word as
+// pack_word() would produce it.
+//
+// Only words [0, answer_count) can be the secret; the rest are accepted as
+// guesses but never chosen. A list loaded from one file has answer_count ==
+// count; wordlist_load_split puts an answer list first and appends the
+// allowed guesses it does not already hold.
+struct WordList {
+    char *letters;
+    uint32_t *packed;
+    size_t count;
+    size_t answer_count;
+};
+
+// Function declarations
+bool wordlist_load(const char *filename, WordList *list);
+bool wordlist_load_split(const char *answers_file, const char *guesses_file, WordList *list);
+void wordlist_free(WordList *list);
+size_t wordlist_text_offsets(const char *data, size_t size, uint32_t *offsets);
+
+static inline const char *wordlist_word(const WordList *list, size_t index) {
+    return list->letters + index * WORD_LENGTH;
+}
+
+#endif